@@ -0,0 +1,89 @@
+#include "../find_all_nulls.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// with_simd::compact_nulls and find_all_nulls vs the erase-remove idiom
+
+namespace
+{
+    constexpr size_t count = 4'000'000;
+
+    // every null_ratio-th element (on average) is null
+    template <typename TPointer, typename TFactory>
+    std::vector<TPointer> make_pointers(double null_ratio, TFactory make)
+    {
+        std::mt19937 gen {42};
+        std::bernoulli_distribution is_null {null_ratio};
+
+        std::vector<TPointer> ptrs;
+        ptrs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            ptrs.push_back(is_null(gen) ? nullptr : make());
+
+        return ptrs;
+    }
+
+    // containers are modified in place, so every run gets a fresh one - only f(ptrs) is timed
+    template <typename TPointer, typename TFactory, typename TFunction>
+    double measure_in_place(double null_ratio, TFactory make, TFunction f, int repetitions = 3)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto ptrs = make_pointers<TPointer>(null_ratio, make);
+
+            const auto start = Bench::Clock::now();
+            f(ptrs);
+            const auto stop = Bench::Clock::now();
+            Bench::do_not_optimize(ptrs);
+
+            const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+            best = (i == 0) ? elapsed : std::min(best, elapsed);
+        }
+
+        return best;
+    }
+
+    template <typename TPointer, typename TFactory>
+    void run(const std::string& kind, TFactory make)
+    {
+        for (double null_ratio : {0.001, 0.1, 0.5})
+        {
+            const std::string suffix = kind + ", " + std::to_string(int(null_ratio * 1000) / 10.0).substr(0, 4) + "% nulls";
+
+            const double erase_remove_ns = measure_in_place<TPointer>(null_ratio, make, [](auto& ptrs) {
+                ptrs.erase(std::remove(ptrs.begin(), ptrs.end(), nullptr), ptrs.end());
+            });
+            Bench::report("erase-remove - " + suffix, erase_remove_ns, count);
+
+            const double compact_ns = measure_in_place<TPointer>(null_ratio, make, [](auto& ptrs) {
+                with_simd::compact_nulls(ptrs);
+            });
+            Bench::report("compact_nulls - " + suffix, compact_ns, count);
+
+            const auto ptrs = make_pointers<TPointer>(null_ratio, make);
+            const double find_all_ns = Bench::measure_ns([&] {
+                auto nulls = with_simd::find_all_nulls(ptrs);
+                Bench::do_not_optimize(nulls);
+            });
+            Bench::report("find_all_nulls - " + suffix, find_all_ns, count);
+        }
+    }
+}
+
+int main()
+{
+    std::cout << count << " pointers per container\n";
+
+    static int value = 1;
+    run<int*>("int*", [] { return &value; });
+    run<std::unique_ptr<int>>("unique_ptr", [] { return std::make_unique<int>(1); });
+    run<std::shared_ptr<int>>("shared_ptr", [] { return std::make_shared<int>(1); });
+}
@@ -0,0 +1,287 @@
+#include "../find_null.hpp"
+#include "../find_null_parallel.hpp"
+#include "../find_null_simd.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// find_null variants x containers x pointer kinds x range sizes x position of the first null
+// usage: find_null_matrix_bench [max_size]
+//
+// - time is reported per element scanned (first null position + 1, or size when there is no null)
+// - "initializer_list" is measured through a const C array: a std::initializer_list of a size known
+//   only at run time cannot be created, and it is iterated with the same const T* iterators
+
+namespace
+{
+    struct Result
+    {
+        std::string container;
+        std::string pointer;
+        size_t size;
+        std::string algorithm;
+        double ns_per_element;
+    };
+
+    std::vector<Result> results;
+
+    // owns the pointees of raw pointers and unique_ptrs for one run, shared_ptrs share a single object
+    template <typename TPointer>
+    struct PointerFactory;
+
+    template <>
+    struct PointerFactory<int*>
+    {
+        std::vector<int> values;
+
+        explicit PointerFactory(size_t count)
+            : values(count)
+        {
+        }
+
+        int* make(size_t i)
+        {
+            return &values[i];
+        }
+    };
+
+    template <>
+    struct PointerFactory<std::unique_ptr<int>>
+    {
+        explicit PointerFactory(size_t)
+        {
+        }
+
+        std::unique_ptr<int> make(size_t i)
+        {
+            return std::make_unique<int>(static_cast<int>(i));
+        }
+    };
+
+    template <>
+    struct PointerFactory<std::shared_ptr<int>>
+    {
+        std::shared_ptr<int> value = std::make_shared<int>(1);
+
+        explicit PointerFactory(size_t)
+        {
+        }
+
+        std::shared_ptr<int> make(size_t)
+        {
+            return value;
+        }
+    };
+
+    template <typename TContainer>
+    struct has_iterator_type
+    {
+        template <typename T>
+        static std::true_type test(typename T::iterator*);
+
+        template <typename T>
+        static std::false_type test(...);
+
+        static constexpr bool value = decltype(test<TContainer>(nullptr))::value;
+    };
+
+    template <typename TContainer>
+    size_t position_of(TContainer& container, decltype(std::begin(container)) pos)
+    {
+        return static_cast<size_t>(std::distance(std::begin(container), pos));
+    }
+
+    template <typename TContainer, typename TFind>
+    void measure(const std::string& container_name, const std::string& pointer_name, TContainer& container, size_t size,
+        size_t first_null, const std::string& algorithm, TFind find)
+    {
+        const size_t scanned = std::min(size, first_null + 1);
+        const int repetitions = size >= (size_t(1) << 20) ? 3 : 10;
+        const size_t calls = std::max<size_t>(1, 65'536 / scanned); // short scans are repeated to get above timer resolution
+
+        size_t found = 0;
+        const double ns = Bench::measure_ns([&] {
+            for (size_t i = 0; i < calls; ++i)
+            {
+                found = position_of(container, find(container));
+                Bench::do_not_optimize(found);
+            }
+        }, repetitions) / calls;
+
+        if (found != first_null)
+        {
+            std::cerr << algorithm << " returned " << found << " instead of " << first_null << "\n";
+            std::exit(1);
+        }
+
+        results.push_back({container_name, pointer_name, size, algorithm, ns / scanned});
+
+        std::cout << std::left << std::setw(18) << container_name << std::setw(12) << pointer_name << std::right << std::setw(10) << size
+                  << std::setw(10) << first_null << "  " << std::left << std::setw(20) << algorithm << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << ns / scanned << "\n";
+    }
+
+    template <typename TContainer>
+    void measure_step_1(const std::string& container_name, const std::string& pointer_name, TContainer& container, size_t size,
+        size_t first_null, std::true_type)
+    {
+        measure(container_name, pointer_name, container, size, first_null, "step_1", [](TContainer& c) { return step_1::find_null(c); });
+    }
+
+    template <typename TContainer>
+    void measure_step_1(const std::string&, const std::string&, TContainer&, size_t, size_t, std::false_type)
+    {
+        // step_1 needs TContainer::iterator - not available for C arrays
+    }
+
+    template <typename TContainer>
+    void measure_all(const std::string& container_name, const std::string& pointer_name, TContainer& container, size_t size, size_t first_null)
+    {
+        measure_step_1(container_name, pointer_name, container, size, first_null,
+            std::integral_constant<bool, has_iterator_type<TContainer>::value> {});
+        measure(container_name, pointer_name, container, size, first_null, "step_2", [](TContainer& c) { return step_2::find_null(c); });
+        measure(container_name, pointer_name, container, size, first_null, "with_std_algorithm",
+            [](TContainer& c) { return with_std_algorithm::find_null(c); });
+        measure(container_name, pointer_name, container, size, first_null, "with_simd", [](TContainer& c) { return with_simd::find_null(c); });
+        measure(container_name, pointer_name, container, size, first_null, "in_parallel",
+            [](TContainer& c) { return in_parallel::find_null(c); });
+    }
+
+    // one null at the given fraction of the range (none for 1.0)
+    const double null_positions[] = {0.01, 0.5, 1.0};
+
+    size_t null_index(size_t size, double fraction)
+    {
+        return fraction >= 1.0 ? size : static_cast<size_t>(size * fraction);
+    }
+
+    template <template <typename...> class TContainer, typename TPointer>
+    void run_container(const std::string& container_name, const std::string& pointer_name, size_t size)
+    {
+        PointerFactory<TPointer> factory {size};
+        TContainer<TPointer> container;
+        for (size_t i = 0; i < size; ++i)
+            container.push_back(factory.make(i));
+
+        for (double fraction : null_positions)
+        {
+            const size_t first_null = null_index(size, fraction);
+            if (first_null == size)
+            {
+                measure_all(container_name, pointer_name, container, size, first_null);
+                continue;
+            }
+
+            auto pos = std::next(container.begin(), static_cast<std::ptrdiff_t>(first_null));
+            TPointer saved = std::move(*pos);
+            *pos = nullptr;
+
+            measure_all(container_name, pointer_name, container, size, first_null);
+
+            *pos = std::move(saved);
+        }
+    }
+
+    template <typename TPointer, size_t N>
+    void run_arrays(const std::string& pointer_name)
+    {
+        using Array = TPointer[N];
+        using ConstArray = const TPointer[N];
+
+        PointerFactory<TPointer> factory {N};
+        std::unique_ptr<Array[]> storage {new Array[1]};
+        Array& array = storage[0];
+        for (size_t i = 0; i < N; ++i)
+            array[i] = factory.make(i);
+
+        for (double fraction : null_positions)
+        {
+            const size_t first_null = null_index(N, fraction);
+
+            TPointer saved {};
+            if (first_null < N)
+            {
+                saved = std::move(array[first_null]);
+                array[first_null] = nullptr;
+            }
+
+            measure_all("C array", pointer_name, array, N, first_null);
+
+            ConstArray& list_view = array;
+            measure_all("initializer_list*", pointer_name, list_view, N, first_null);
+
+            if (first_null < N)
+                array[first_null] = std::move(saved);
+        }
+    }
+
+    template <typename TPointer, size_t N>
+    void run_size(const std::string& pointer_name)
+    {
+        run_container<std::vector, TPointer>("vector", pointer_name, N);
+        run_container<std::deque, TPointer>("deque", pointer_name, N);
+        run_container<std::list, TPointer>("list", pointer_name, N);
+        run_arrays<TPointer, N>(pointer_name);
+    }
+
+    template <size_t N>
+    void run_all_pointers(size_t max_size)
+    {
+        if (N > max_size)
+            return;
+
+        std::cout << "\n--- " << N << " elements, " << N * sizeof(void*) / 1024 << " KiB of raw pointers ---\n";
+        run_size<int*, N>("int*");
+        run_size<std::unique_ptr<int>, N>("unique_ptr");
+        run_size<std::shared_ptr<int>, N>("shared_ptr");
+    }
+
+    // best algorithm for every container and pointer kind, fastest first
+    void print_summary()
+    {
+        std::map<size_t, std::map<std::string, std::pair<double, std::string>>> best;
+        for (const Result& r : results)
+        {
+            auto& entry = best[r.size][r.container + " of " + r.pointer];
+            if (entry.second.empty() || r.ns_per_element < entry.first)
+                entry = {r.ns_per_element, r.algorithm};
+        }
+
+        std::cout << "\n=== fastest layout per size (best algorithm, ns per element scanned) ===\n";
+        for (const auto& per_size : best)
+        {
+            std::vector<std::pair<double, std::string>> ranking;
+            for (const auto& layout : per_size.second)
+                ranking.push_back({layout.second.first, layout.first + " (" + layout.second.second + ")"});
+            std::sort(ranking.begin(), ranking.end());
+
+            std::cout << "\n" << per_size.first << " elements:\n";
+            for (const auto& entry : ranking)
+                std::cout << "  " << std::fixed << std::setprecision(3) << std::setw(8) << entry.first << "  " << entry.second << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t max_size = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 24);
+
+    std::cout << std::left << std::setw(18) << "container" << std::setw(12) << "pointer" << std::right << std::setw(10) << "size"
+              << std::setw(10) << "null at" << "  " << std::left << std::setw(20) << "algorithm" << std::right << std::setw(10)
+              << "ns/elem" << "\n";
+
+    run_all_pointers<size_t(1) << 10>(max_size); // L1
+    run_all_pointers<size_t(1) << 16>(max_size); // L2
+    run_all_pointers<size_t(1) << 20>(max_size); // L3
+    run_all_pointers<size_t(1) << 24>(max_size); // DRAM
+
+    print_summary();
+}
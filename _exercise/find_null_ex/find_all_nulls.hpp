@@ -0,0 +1,308 @@
+#ifndef FIND_ALL_NULLS_HPP_
+#define FIND_ALL_NULLS_HPP_
+
+#include "find_null_simd.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace with_simd
+{
+    namespace detail
+    {
+        inline size_t popcount(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_popcountll(word));
+#else
+            size_t count = 0;
+            for (; word != 0; word &= word - 1)
+                ++count;
+
+            return count;
+#endif
+        }
+
+        // word must not be zero
+        inline size_t lowest_bit(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(word));
+#else
+            size_t index = 0;
+            for (; (word & 1u) == 0; word >>= 1)
+                ++index;
+
+            return index;
+#endif
+        }
+    }
+
+    // one bit per element of a range - set for nulls
+    class NullBitmap
+    {
+        std::vector<std::uint64_t> words_;
+        size_t size_;
+
+    public:
+        explicit NullBitmap(size_t size = 0)
+            : words_((size + 63) / 64)
+            , size_ {size}
+        {
+        }
+
+        size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        bool operator[](size_t index) const noexcept
+        {
+            return (words_[index / 64] >> (index % 64)) & 1u;
+        }
+
+        void set(size_t index) noexcept
+        {
+            words_[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+
+        // number of nulls
+        size_t count() const noexcept
+        {
+            size_t result = 0;
+            for (std::uint64_t word : words_)
+                result += detail::popcount(word);
+
+            return result;
+        }
+
+        std::vector<size_t> indices() const
+        {
+            std::vector<size_t> result;
+            result.reserve(count());
+
+            for (size_t w = 0; w < words_.size(); ++w)
+            {
+                for (std::uint64_t word = words_[w]; word != 0; word &= word - 1)
+                    result.push_back(w * 64 + detail::lowest_bit(word));
+            }
+
+            return result;
+        }
+
+        // word i holds elements [64 * i, 64 * i + 64), bit 0 is the first one
+        std::uint64_t* words() noexcept
+        {
+            return words_.data();
+        }
+
+        const std::uint64_t* words() const noexcept
+        {
+            return words_.data();
+        }
+    };
+
+    namespace detail
+    {
+        // kernels set bit i of mask when word i (of at most 64) is zero
+
+        inline std::uint64_t zero_word_mask_scalar(const void* words, size_t count)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(words);
+            std::uint64_t mask = 0;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::uintptr_t word;
+                std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+
+                mask |= std::uint64_t(word == 0) << i;
+            }
+
+            return mask;
+        }
+
+#ifdef FIND_NULL_HAS_X86_KERNELS
+        __attribute__((target("sse2"))) inline std::uint64_t zero_word_mask_sse2(const void* words, size_t count)
+        {
+            const __m128i* data = static_cast<const __m128i*>(words);
+            const __m128i zero = _mm_setzero_si128();
+            std::uint64_t mask = 0;
+
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2, ++data)
+            {
+                const __m128i halves = _mm_cmpeq_epi32(_mm_loadu_si128(data), zero);
+                const __m128i nulls = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+
+                mask |= std::uint64_t(_mm_movemask_pd(_mm_castsi128_pd(nulls))) << i;
+            }
+
+            if (i < count)
+                mask |= zero_word_mask_scalar(static_cast<const std::uintptr_t*>(words) + i, count - i) << i;
+
+            return mask;
+        }
+
+        __attribute__((target("avx2"))) inline std::uint64_t zero_word_mask_avx2(const void* words, size_t count)
+        {
+            const __m256i* data = static_cast<const __m256i*>(words);
+            const __m256i zero = _mm256_setzero_si256();
+            std::uint64_t mask = 0;
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4, ++data)
+            {
+                const __m256i nulls = _mm256_cmpeq_epi64(_mm256_loadu_si256(data), zero);
+                mask |= std::uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(nulls))) << i;
+            }
+
+            if (i < count)
+                mask |= zero_word_mask_scalar(static_cast<const std::uintptr_t*>(words) + i, count - i) << i;
+
+            return mask;
+        }
+#endif
+
+        using ZeroWordMask = std::uint64_t (*)(const void*, size_t);
+
+        inline ZeroWordMask select_mask_kernel()
+        {
+#ifdef FIND_NULL_HAS_X86_KERNELS
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+                return &zero_word_mask_avx2;
+
+            if (__builtin_cpu_supports("sse2"))
+                return &zero_word_mask_sse2;
+#endif
+            return &zero_word_mask_scalar;
+        }
+
+        inline std::uint64_t zero_word_mask(const void* words, size_t count)
+        {
+            static const ZeroWordMask kernel = select_mask_kernel();
+            return kernel(words, count);
+        }
+
+        template <typename TIterator>
+        NullBitmap find_all_nulls(TIterator first, TIterator last, std::true_type)
+        {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            NullBitmap nulls {count};
+
+            if (count != 0)
+            {
+                const auto* elements = std::addressof(*first);
+                for (size_t block = 0; block < count; block += 64)
+                    nulls.words()[block / 64] = zero_word_mask(elements + block, std::min<size_t>(64, count - block));
+            }
+
+            return nulls;
+        }
+
+        template <typename TIterator>
+        NullBitmap find_all_nulls(TIterator first, TIterator last, std::false_type)
+        {
+            NullBitmap nulls {static_cast<size_t>(std::distance(first, last))};
+
+            size_t index = 0;
+            for (; first != last; ++first, ++index)
+            {
+                if (*first == nullptr)
+                    nulls.set(index);
+            }
+
+            return nulls;
+        }
+
+        // Elements are moved as pointer words: the word is copied and the slots left behind are zeroed,
+        // which is what moving a raw pointer or a unique_ptr with the default deleter does.
+        // Blocks of 64 elements without nulls are moved as a whole, other blocks without branches.
+        template <typename TIterator>
+        TIterator compact_nulls(TIterator first, TIterator last, std::true_type)
+        {
+            constexpr size_t word_size = sizeof(std::uintptr_t);
+            static_assert(sizeof(typename std::iterator_traits<TIterator>::value_type) == word_size, "elements must be pointer words");
+
+            const size_t count = static_cast<size_t>(last - first);
+            if (count == 0)
+                return last;
+
+            unsigned char* words = reinterpret_cast<unsigned char*>(std::addressof(*first));
+            size_t write = 0;
+
+            for (size_t block = 0; block < count; block += 64)
+            {
+                const size_t block_size = std::min<size_t>(64, count - block);
+                const std::uint64_t nulls = zero_word_mask(words + block * word_size, block_size);
+
+                if (nulls == 0)
+                {
+                    if (write != block)
+                        std::memmove(words + write * word_size, words + block * word_size, block_size * word_size);
+
+                    write += block_size;
+                    continue;
+                }
+
+                for (size_t i = block; i < block + block_size; ++i)
+                {
+                    std::uintptr_t word;
+                    std::memcpy(&word, words + i * word_size, word_size);
+                    std::memcpy(words + write * word_size, &word, word_size);
+                    write += (word != 0);
+                }
+            }
+
+            std::memset(words + write * word_size, 0, (count - write) * word_size);
+
+            return first + write;
+        }
+
+        template <typename TIterator>
+        TIterator compact_nulls(TIterator first, TIterator last, std::false_type)
+        {
+            return std::remove(first, last, nullptr);
+        }
+    }
+
+    template <typename TIterator>
+    NullBitmap find_all_nulls(TIterator first, TIterator last)
+    {
+        return detail::find_all_nulls(first, last, detail::is_pointer_word_range<TIterator> {});
+    }
+
+    template <typename TContainer>
+    NullBitmap find_all_nulls(const TContainer& container)
+    {
+        return find_all_nulls(std::begin(container), std::end(container));
+    }
+
+    // moves non-null elements to the front, keeping their order, and returns the new end (as std::remove);
+    // elements after it are moved-from
+    template <typename TIterator>
+    TIterator compact_nulls(TIterator first, TIterator last)
+    {
+        return detail::compact_nulls(first, last, detail::is_pointer_word_range<TIterator> {});
+    }
+
+    // removes nulls from the container, returns the number of removed elements
+    template <typename TContainer>
+    size_t compact_nulls(TContainer& container)
+    {
+        const auto old_size = container.size();
+        container.erase(compact_nulls(container.begin(), container.end()), container.end());
+
+        return old_size - container.size();
+    }
+}
+
+#endif /*FIND_ALL_NULLS_HPP_*/
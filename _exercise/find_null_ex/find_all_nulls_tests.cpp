@@ -0,0 +1,99 @@
+#include "catch.hpp"
+#include "find_all_nulls.hpp"
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("with_simd::find_all_nulls")
+{
+    SECTION("raw pointers - positions in and across 64-element blocks")
+    {
+        int x = 1;
+        vector<int*> ptrs(200, &x);
+        const vector<size_t> nulls = {0, 3, 63, 64, 127, 130, 199};
+        for (size_t pos : nulls)
+            ptrs[pos] = nullptr;
+
+        const auto bitmap = with_simd::find_all_nulls(ptrs);
+
+        REQUIRE(bitmap.size() == 200);
+        REQUIRE(bitmap.count() == nulls.size());
+        REQUIRE(bitmap.indices() == nulls);
+        REQUIRE(bitmap[63]);
+        REQUIRE_FALSE(bitmap[62]);
+    }
+
+    SECTION("unique_ptrs, shared_ptrs in a deque and a C array")
+    {
+        vector<unique_ptr<int>> owners(5);
+        owners[1] = make_unique<int>(1);
+        REQUIRE(with_simd::find_all_nulls(owners).indices() == (vector<size_t> {0, 2, 3, 4}));
+
+        deque<shared_ptr<int>> shared = {make_shared<int>(1), nullptr, make_shared<int>(2)};
+        REQUIRE(with_simd::find_all_nulls(shared).indices() == vector<size_t> {1});
+
+        int x = 1;
+        int* array[] = {&x, nullptr, &x};
+        REQUIRE(with_simd::find_all_nulls(array).indices() == vector<size_t> {1});
+    }
+}
+
+TEST_CASE("with_simd::compact_nulls")
+{
+    SECTION("raw pointers keep their order")
+    {
+        int values[300];
+        vector<int*> ptrs;
+        vector<int*> expected;
+        for (int i = 0; i < 300; ++i)
+        {
+            const bool is_null = (i % 7 == 0) || (i >= 64 && i < 128 && i % 2 == 0);
+            ptrs.push_back(is_null ? nullptr : &values[i]);
+            if (!is_null)
+                expected.push_back(&values[i]);
+        }
+
+        REQUIRE(with_simd::compact_nulls(ptrs) == 300 - expected.size());
+        REQUIRE(ptrs == expected);
+    }
+
+    SECTION("unique_ptrs are moved, not leaked or destroyed")
+    {
+        vector<unique_ptr<int>> owners;
+        for (int i = 0; i < 150; ++i)
+            owners.push_back(i % 3 == 1 ? nullptr : make_unique<int>(i));
+
+        REQUIRE(with_simd::compact_nulls(owners) == 50);
+        REQUIRE(owners.size() == 100);
+        REQUIRE(*owners[0] == 0);
+        REQUIRE(*owners[1] == 2);
+        REQUIRE(*owners.back() == 149);
+        REQUIRE(with_simd::find_null(owners) == owners.end());
+    }
+
+    SECTION("shared_ptrs in a list")
+    {
+        auto shared = make_shared<int>(7);
+        list<shared_ptr<int>> ptrs = {nullptr, shared, nullptr, shared};
+
+        REQUIRE(with_simd::compact_nulls(ptrs) == 2);
+        REQUIRE(ptrs.size() == 2);
+        REQUIRE(shared.use_count() == 3);
+    }
+
+    SECTION("C array - returns the new end")
+    {
+        int x = 1, y = 2;
+        int* array[] = {nullptr, &x, nullptr, &y};
+
+        int** new_end = with_simd::compact_nulls(begin(array), end(array));
+
+        REQUIRE(new_end == array + 2);
+        REQUIRE(array[0] == &x);
+        REQUIRE(array[1] == &y);
+    }
+}
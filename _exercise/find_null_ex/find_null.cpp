@@ -1,6 +1,8 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+#include "find_null.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <iterator>
@@ -9,69 +11,6 @@
 
 using namespace std;
 
-namespace step_1
-{
-    template <typename TContainer>
-    typename TContainer::iterator find_null(TContainer& v)
-    {
-        auto it = v.begin();
-
-        for (; it != v.end(); it++)
-        {
-            if (*it == nullptr)
-            {
-                return it;
-            }
-        }
-        return it;
-    }
-}
-
-namespace explain
-{
-    template <typename TContainer>
-    auto begin(TContainer& container)
-    {
-        return container.begin();
-    }
-
-    template <typename T, size_t N>
-    auto begin(T(&array)[N])
-    {
-        return &array[0];
-    }
-
-    template <typename TContainer>
-    auto end(TContainer& container)
-    {
-        return container.end();
-    }
-
-    template <typename T, size_t N>
-    auto end(T(&array)[N])
-    {
-        return array + N;
-    }
-}
-
-namespace step_2
-{
-    template <typename TContainer>
-    auto find_null(TContainer& v) -> decltype(begin(v))
-    {
-        auto it = begin(v);
-
-        for (; it != end(v); it++)
-        {
-            if (*it == nullptr)
-            {
-                return it;
-            }
-        }
-        return it;
-    }
-}
-
 TEST_CASE("bug with && approach")
 {
     int x = 10;
@@ -80,15 +19,6 @@ TEST_CASE("bug with && approach")
     // REQUIRE(*pos_nullptr == nullptr);
 }
 
-namespace with_std_algorithm
-{
-    template <typename TContainer>
-    auto find_null(TContainer& arg) -> decltype(begin(arg))
-    {
-        return std::find(begin(arg), end(arg), nullptr);
-    }
-}
-
 TEST_CASE("find_null description")
 {
     using namespace step_2;
@@ -146,4 +76,37 @@ TEST_CASE("find_null description")
 
         REQUIRE(find_null(il) == il.end());
     }
-}
\ No newline at end of file
+}
+TEST_CASE("find_null - long ranges of pointers take the vectorized path")
+{
+    int x = 10;
+
+    vector<int*> ptrs(100, &x);
+    ptrs[70] = nullptr;
+    ptrs[90] = nullptr;
+
+    int* array[40];
+    fill(begin(array), end(array), &x);
+    array[33] = nullptr;
+
+    vector<unique_ptr<int>> owners;
+    for (int i = 0; i < 50; ++i)
+        owners.push_back(i == 41 ? nullptr : make_unique<int>(i));
+
+    REQUIRE(distance(ptrs.begin(), step_1::find_null(ptrs)) == 70);
+    REQUIRE(distance(ptrs.begin(), step_2::find_null(ptrs)) == 70);
+    REQUIRE(distance(ptrs.begin(), with_std_algorithm::find_null(ptrs)) == 70);
+
+    REQUIRE(distance(begin(array), step_2::find_null(array)) == 33);
+    REQUIRE(distance(begin(array), with_std_algorithm::find_null(array)) == 33);
+
+    REQUIRE(distance(owners.begin(), step_2::find_null(owners)) == 41);
+    REQUIRE(distance(owners.begin(), with_std_algorithm::find_null(owners)) == 41);
+
+    const vector<int*>& const_ptrs = ptrs;
+    REQUIRE(distance(const_ptrs.begin(), step_2::find_null(const_ptrs)) == 70);
+
+    ptrs[70] = ptrs[90] = &x;
+    REQUIRE(step_2::find_null(ptrs) == ptrs.end());
+    REQUIRE(with_std_algorithm::find_null(ptrs) == ptrs.end());
+}
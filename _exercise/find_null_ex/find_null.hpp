@@ -0,0 +1,102 @@
+#ifndef FIND_NULL_HPP_
+#define FIND_NULL_HPP_
+
+#include "find_null_simd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// contiguous ranges of raw pointers and unique_ptrs are scanned with the kernels from find_null_simd.hpp
+
+namespace step_1
+{
+    namespace detail
+    {
+        template <typename TIterator>
+        TIterator find_null(TIterator it, TIterator last, std::false_type)
+        {
+            for (; it != last; it++)
+            {
+                if (*it == nullptr)
+                {
+                    return it;
+                }
+            }
+            return it;
+        }
+
+        template <typename TIterator>
+        TIterator find_null(TIterator first, TIterator last, std::true_type)
+        {
+            return with_simd::detail::find_null(first, last, std::true_type {});
+        }
+    }
+
+    template <typename TContainer>
+    typename TContainer::iterator find_null(TContainer& v)
+    {
+        using Iterator = typename TContainer::iterator;
+
+        return detail::find_null(v.begin(), v.end(), with_simd::detail::is_pointer_word_range<Iterator> {});
+    }
+}
+
+namespace explain
+{
+    template <typename TContainer>
+    auto begin(TContainer& container)
+    {
+        return container.begin();
+    }
+
+    template <typename T, size_t N>
+    auto begin(T(&array)[N])
+    {
+        return &array[0];
+    }
+
+    template <typename TContainer>
+    auto end(TContainer& container)
+    {
+        return container.end();
+    }
+
+    template <typename T, size_t N>
+    auto end(T(&array)[N])
+    {
+        return array + N;
+    }
+}
+
+namespace step_2
+{
+    using std::begin;
+    using std::end;
+
+    template <typename TContainer>
+    auto find_null(TContainer& v) -> decltype(begin(v))
+    {
+        using Iterator = decltype(begin(v));
+
+        return step_1::detail::find_null(begin(v), end(v), with_simd::detail::is_pointer_word_range<Iterator> {});
+    }
+}
+
+namespace with_std_algorithm
+{
+    using std::begin;
+    using std::end;
+
+    // std::find for ranges the kernels do not handle
+    template <typename TContainer>
+    auto find_null(TContainer& arg) -> decltype(begin(arg))
+    {
+        using Iterator = decltype(begin(arg));
+
+        return with_simd::detail::find_null(begin(arg), end(arg), with_simd::detail::is_pointer_word_range<Iterator> {});
+    }
+}
+
+#endif /*FIND_NULL_HPP_*/
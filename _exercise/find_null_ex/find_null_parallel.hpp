@@ -0,0 +1,118 @@
+#ifndef FIND_NULL_PARALLEL_HPP_
+#define FIND_NULL_PARALLEL_HPP_
+
+#include "find_null_simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace in_parallel
+{
+    namespace detail
+    {
+        constexpr size_t chunk_size = size_t(1) << 16;
+
+        // hardware_concurrency() reads system files on every call - far too slow for short ranges
+        inline unsigned default_thread_count()
+        {
+            static const unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+            return thread_count;
+        }
+
+        // chunks are claimed in order, so when a null is found every earlier chunk is already being scanned
+        // and workers can skip all the chunks after it
+        template <typename TIterator>
+        TIterator find_null(TIterator first, TIterator last, unsigned thread_count, std::random_access_iterator_tag)
+        {
+            const size_t count = static_cast<size_t>(last - first);
+            const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+            if (chunk_count <= 1)
+                return with_simd::find_null(first, last);
+
+            if (thread_count == 0)
+                thread_count = default_thread_count();
+
+            if (thread_count == 1)
+                return with_simd::find_null(first, last);
+
+            std::atomic<size_t> next_chunk {0};
+            std::atomic<size_t> first_null {count};
+
+            auto scan_chunks = [&] {
+                for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                {
+                    const size_t chunk_begin = chunk * chunk_size;
+                    if (chunk_begin >= first_null.load(std::memory_order_relaxed))
+                        return;
+
+                    const size_t chunk_end = std::min(count, chunk_begin + chunk_size);
+                    const TIterator pos = with_simd::find_null(first + chunk_begin, first + chunk_end);
+
+                    if (pos != first + chunk_end)
+                    {
+                        const size_t index = static_cast<size_t>(pos - first);
+                        size_t current = first_null.load(std::memory_order_relaxed);
+                        while (index < current && !first_null.compare_exchange_weak(current, index, std::memory_order_relaxed))
+                        {
+                        }
+
+                        return;
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(thread_count - 1);
+
+            try
+            {
+                for (unsigned i = 1; i < std::min<size_t>(thread_count, chunk_count); ++i)
+                    workers.emplace_back(scan_chunks);
+            }
+            catch (const std::system_error&)
+            {
+                // fewer workers only make the search slower - chunks are shared
+            }
+            catch (...)
+            {
+                for (auto& worker : workers)
+                    worker.join();
+                throw;
+            }
+
+            scan_chunks();
+
+            for (auto& worker : workers)
+                worker.join();
+
+            return first + first_null.load();
+        }
+
+        template <typename TIterator, typename TCategory>
+        TIterator find_null(TIterator first, TIterator last, unsigned, TCategory)
+        {
+            return with_simd::find_null(first, last);
+        }
+    }
+
+    // returns the first null, like the serial versions; ranges without random access are scanned serially
+    // thread_count == 0 uses all hardware threads
+    template <typename TIterator>
+    TIterator find_null(TIterator first, TIterator last, unsigned thread_count = 0)
+    {
+        return detail::find_null(first, last, thread_count, typename std::iterator_traits<TIterator>::iterator_category {});
+    }
+
+    template <typename TContainer>
+    auto find_null(TContainer& container, unsigned thread_count = 0) -> decltype(std::begin(container))
+    {
+        return find_null(std::begin(container), std::end(container), thread_count);
+    }
+}
+
+#endif /*FIND_NULL_PARALLEL_HPP_*/
@@ -0,0 +1,80 @@
+#include "catch.hpp"
+#include "find_null_parallel.hpp"
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("in_parallel::find_null - containers from the find_null description")
+{
+    SECTION("std container of raw pointers")
+    {
+        int x = 1;
+        vector<int*> ptrs = {&x, &x, NULL, &x, nullptr, &x};
+
+        REQUIRE(distance(ptrs.begin(), in_parallel::find_null(ptrs, 4)) == 2);
+    }
+
+    SECTION("array of raw pointers")
+    {
+        int x = 1;
+        int* ptrs[] = {&x, &x, NULL, &x, nullptr, &x};
+
+        REQUIRE(distance(begin(ptrs), in_parallel::find_null(ptrs, 4)) == 2);
+    }
+
+    SECTION("initializer-list of shared_ptrs")
+    {
+        auto il = {make_shared<int>(10), shared_ptr<int> {}, make_shared<int>(3)};
+
+        REQUIRE(distance(il.begin(), in_parallel::find_null(il, 4)) == 1);
+    }
+
+    SECTION("list of unique_ptrs")
+    {
+        list<unique_ptr<int>> ptrs;
+        ptrs.push_back(make_unique<int>(1));
+        ptrs.push_back(nullptr);
+
+        REQUIRE(in_parallel::find_null(ptrs, 4) == next(ptrs.begin()));
+    }
+}
+
+TEST_CASE("in_parallel::find_null - large ranges")
+{
+    constexpr size_t count = 1'000'000;
+    int x = 1;
+    vector<int*> ptrs(count, &x);
+
+    SECTION("no nulls")
+    {
+        for (unsigned threads : {1u, 2u, 8u})
+            REQUIRE(in_parallel::find_null(ptrs, threads) == ptrs.end());
+    }
+
+    SECTION("returns the first of many nulls in different chunks")
+    {
+        for (size_t first : {size_t(0), size_t(65'535), size_t(65'536), size_t(500'000), count - 1})
+        {
+            fill(ptrs.begin(), ptrs.end(), &x);
+            for (size_t pos = first; pos < count; pos += 70'001)
+                ptrs[pos] = nullptr;
+
+            for (unsigned threads : {1u, 2u, 3u, 8u})
+                REQUIRE(distance(ptrs.begin(), in_parallel::find_null(ptrs, threads)) == static_cast<ptrdiff_t>(first));
+        }
+    }
+
+    SECTION("unique_ptrs")
+    {
+        vector<unique_ptr<int>> owners(count / 4);
+        for (auto& owner : owners)
+            owner = make_unique<int>(1);
+        owners[200'000].reset();
+
+        REQUIRE(distance(owners.begin(), in_parallel::find_null(owners, 4)) == 200'000);
+    }
+}
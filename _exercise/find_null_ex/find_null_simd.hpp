@@ -0,0 +1,174 @@
+#ifndef FIND_NULL_SIMD_HPP_
+#define FIND_NULL_SIMD_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define FIND_NULL_HAS_X86_KERNELS
+#endif
+
+namespace with_simd
+{
+    namespace detail
+    {
+        // elements stored as a single pointer-sized word that is all zero bits when null:
+        // raw pointers and unique_ptrs with the default deleter
+        template <typename T>
+        struct is_pointer_word : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct is_pointer_word<T*> : std::true_type
+        {
+        };
+
+        template <typename T>
+        struct is_pointer_word<std::unique_ptr<T>> : std::integral_constant<bool, sizeof(std::unique_ptr<T>) == sizeof(T*)>
+        {
+        };
+
+        // iterators over elements stored one after another in memory
+        template <typename TIterator, typename T = typename std::iterator_traits<TIterator>::value_type>
+        struct is_contiguous_iterator
+            : std::integral_constant<bool,
+                  std::is_pointer<TIterator>::value
+                      || std::is_same<TIterator, typename std::vector<T>::iterator>::value
+                      || std::is_same<TIterator, typename std::vector<T>::const_iterator>::value>
+        {
+        };
+
+        template <typename TIterator>
+        struct is_pointer_word_range
+            : std::integral_constant<bool,
+                  is_contiguous_iterator<TIterator>::value
+                      && is_pointer_word<typename std::iterator_traits<TIterator>::value_type>::value>
+        {
+        };
+
+        // kernels return the index of the first zero word among count words, or count
+
+        inline size_t find_zero_word_scalar(const void* words, size_t count)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(words);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::uintptr_t word;
+                std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+
+                if (word == 0)
+                    return i;
+            }
+
+            return count;
+        }
+
+#ifdef FIND_NULL_HAS_X86_KERNELS
+        // 8 pointers per iteration - SSE2 has no 64-bit compare, so both 32-bit halves must be zero
+        __attribute__((target("sse2"))) inline size_t find_zero_word_sse2(const void* words, size_t count)
+        {
+            const __m128i* data = static_cast<const __m128i*>(words);
+            const __m128i zero = _mm_setzero_si128();
+
+            auto null_lanes = [&zero](__m128i v) {
+                const __m128i halves = _mm_cmpeq_epi32(v, zero);
+                return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+            };
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8, data += 4)
+            {
+                const __m128i any = _mm_or_si128(_mm_or_si128(null_lanes(_mm_loadu_si128(data)), null_lanes(_mm_loadu_si128(data + 1))),
+                    _mm_or_si128(null_lanes(_mm_loadu_si128(data + 2)), null_lanes(_mm_loadu_si128(data + 3))));
+
+                if (_mm_movemask_epi8(any) != 0)
+                    break;
+            }
+
+            return i + find_zero_word_scalar(static_cast<const std::uintptr_t*>(words) + i, count - i);
+        }
+
+        // 16 pointers per iteration
+        __attribute__((target("avx2"))) inline size_t find_zero_word_avx2(const void* words, size_t count)
+        {
+            const __m256i* data = static_cast<const __m256i*>(words);
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16, data += 4)
+            {
+                const __m256i any = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi64(_mm256_loadu_si256(data), zero), _mm256_cmpeq_epi64(_mm256_loadu_si256(data + 1), zero)),
+                    _mm256_or_si256(_mm256_cmpeq_epi64(_mm256_loadu_si256(data + 2), zero), _mm256_cmpeq_epi64(_mm256_loadu_si256(data + 3), zero)));
+
+                if (_mm256_movemask_epi8(any) != 0)
+                    break;
+            }
+
+            return i + find_zero_word_sse2(static_cast<const std::uintptr_t*>(words) + i, count - i);
+        }
+#endif
+
+        using FindZeroWord = size_t (*)(const void*, size_t);
+
+        inline FindZeroWord select_kernel()
+        {
+#ifdef FIND_NULL_HAS_X86_KERNELS
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+                return &find_zero_word_avx2;
+
+            if (__builtin_cpu_supports("sse2"))
+                return &find_zero_word_sse2;
+#endif
+            return &find_zero_word_scalar;
+        }
+
+        // kernel is chosen once, for the CPU the program runs on
+        inline size_t find_zero_word(const void* words, size_t count)
+        {
+            static const FindZeroWord kernel = select_kernel();
+            return kernel(words, count);
+        }
+
+        template <typename TIterator>
+        TIterator find_null(TIterator first, TIterator last, std::false_type)
+        {
+            return std::find(first, last, nullptr);
+        }
+
+        template <typename TIterator>
+        TIterator find_null(TIterator first, TIterator last, std::true_type)
+        {
+            if (first == last)
+                return last;
+
+            const size_t count = static_cast<size_t>(last - first);
+            return first + find_zero_word(std::addressof(*first), count);
+        }
+    }
+
+    // vectorized for contiguous ranges of raw pointers and unique_ptrs, std::find otherwise
+    template <typename TIterator>
+    TIterator find_null(TIterator first, TIterator last)
+    {
+        return detail::find_null(first, last, detail::is_pointer_word_range<TIterator> {});
+    }
+
+    template <typename TContainer>
+    auto find_null(TContainer& container) -> decltype(std::begin(container))
+    {
+        return find_null(std::begin(container), std::end(container));
+    }
+}
+
+#endif /*FIND_NULL_SIMD_HPP_*/
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include "find_null_simd.hpp"
+
+#include <deque>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    int value = 42;
+
+    // count pointers, nulls at the given positions
+    vector<int*> make_pointers(size_t count, std::initializer_list<size_t> nulls)
+    {
+        vector<int*> ptrs(count, &value);
+        for (size_t pos : nulls)
+            ptrs[pos] = nullptr;
+
+        return ptrs;
+    }
+}
+
+TEST_CASE("with_simd::find_null - raw pointers")
+{
+    SECTION("first null at every position of ranges longer than one vector loop")
+    {
+        for (size_t count : {0u, 1u, 7u, 8u, 16u, 17u, 63u, 100u})
+        {
+            auto no_nulls = make_pointers(count, {});
+            REQUIRE(with_simd::find_null(no_nulls) == no_nulls.end());
+
+            for (size_t pos = 0; pos < count; ++pos)
+            {
+                auto ptrs = make_pointers(count, {pos, count - 1});
+                REQUIRE(distance(ptrs.begin(), with_simd::find_null(ptrs)) == static_cast<ptrdiff_t>(pos));
+            }
+        }
+    }
+
+    SECTION("pointers with a zero 32-bit half are not null")
+    {
+        vector<int*> ptrs(40, reinterpret_cast<int*>(std::uintptr_t(1) << 32));
+        ptrs[33] = nullptr;
+
+        REQUIRE(distance(ptrs.begin(), with_simd::find_null(ptrs)) == 33);
+    }
+
+    SECTION("C array and const vector")
+    {
+        int* array[20] = {};
+        fill(begin(array), end(array), &value);
+        array[18] = nullptr;
+
+        REQUIRE(with_simd::find_null(array) == array + 18);
+
+        const vector<const int*> ptrs(array, array + 20);
+        vector<const int*>::const_iterator pos = with_simd::find_null(ptrs);
+        REQUIRE(distance(ptrs.begin(), pos) == 18);
+    }
+}
+
+TEST_CASE("with_simd::find_null - smart pointers")
+{
+    SECTION("unique_ptrs in a vector")
+    {
+        vector<unique_ptr<int>> ptrs;
+        for (int i = 0; i < 37; ++i)
+            ptrs.push_back(make_unique<int>(i));
+        ptrs[29].reset();
+
+        REQUIRE(distance(ptrs.begin(), with_simd::find_null(ptrs)) == 29);
+    }
+
+    SECTION("non-contiguous containers and shared_ptrs use the generic path")
+    {
+        deque<int*> dq(30, &value);
+        dq[21] = nullptr;
+        REQUIRE(distance(dq.begin(), with_simd::find_null(dq)) == 21);
+
+        list<unique_ptr<int>> lst;
+        lst.push_back(make_unique<int>(1));
+        lst.push_back(nullptr);
+        REQUIRE(with_simd::find_null(lst) == next(lst.begin()));
+
+        auto il = {make_shared<int>(10), shared_ptr<int> {}, make_shared<int>(3)};
+        REQUIRE(distance(il.begin(), with_simd::find_null(il)) == 1);
+    }
+}
+
+#ifdef FIND_NULL_HAS_X86_KERNELS
+TEST_CASE("with_simd::find_null - every kernel gives the same result")
+{
+    using namespace with_simd::detail;
+
+    vector<FindZeroWord> kernels = {&find_zero_word_scalar, &find_zero_word_sse2};
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back(&find_zero_word_avx2);
+
+    for (size_t count : {0u, 5u, 16u, 33u, 130u})
+    {
+        for (size_t pos = 0; pos <= count; ++pos)
+        {
+            auto ptrs = make_pointers(count + 1, {pos});
+            for (FindZeroWord kernel : kernels)
+                REQUIRE(kernel(ptrs.data(), count) == pos);
+        }
+    }
+}
+#endif
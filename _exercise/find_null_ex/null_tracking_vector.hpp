@@ -0,0 +1,240 @@
+#ifndef NULL_TRACKING_VECTOR_HPP_
+#define NULL_TRACKING_VECTOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace null_tracking
+{
+    // Vector of pointers (raw or smart) that keeps track of its nulls
+    // - elements are changed only through set()/reset()/take()/push_back()/pop_back(),
+    //   each of them updates a hierarchical bitmap of nulls in O(log64 n)
+    // - first_null() and next_null() are O(log64 n), null_count() is O(1)
+    template <typename TPointer>
+    class NullTrackingVector
+    {
+        static constexpr size_t word_bits = 64;
+
+        std::vector<TPointer> items_;
+        // levels_[0] has one bit per element (set for nulls),
+        // a bit of levels_[k] is set when the corresponding word of levels_[k - 1] is not zero
+        std::vector<std::vector<std::uint64_t>> levels_;
+        size_t null_count_ = 0;
+
+        static std::uint64_t bit(size_t index) noexcept
+        {
+            return std::uint64_t(1) << (index % word_bits);
+        }
+
+        // word must not be zero
+        static size_t lowest_bit(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(word));
+#else
+            size_t index = 0;
+            for (; (word & 1u) == 0; word >>= 1)
+                ++index;
+
+            return index;
+#endif
+        }
+
+        // adds zero words (and levels) so that size elements can be tracked
+        void reserve_levels(size_t size)
+        {
+            size_t bits = size;
+            size_t level = 0;
+
+            do
+            {
+                const size_t words = (bits + word_bits - 1) / word_bits;
+                if (level == levels_.size())
+                    levels_.emplace_back();
+                if (levels_[level].size() < words)
+                    levels_[level].resize(words, 0);
+
+                bits = levels_[level].size();
+                ++level;
+            } while (bits > 1);
+        }
+
+        void mark(size_t index, bool is_null)
+        {
+            if (((levels_[0][index / word_bits] & bit(index)) != 0) == is_null)
+                return;
+
+            if (is_null)
+                ++null_count_;
+            else
+                --null_count_;
+
+            for (size_t level = 0; level < levels_.size(); ++level)
+            {
+                std::uint64_t& word = levels_[level][index / word_bits];
+                const bool was_empty = (word == 0);
+
+                word ^= bit(index);
+
+                // the parent bit changes only when the word becomes empty or stops being empty
+                if (was_empty == (word == 0))
+                    break;
+
+                index /= word_bits;
+            }
+        }
+
+        // index of the first set bit of levels_[0] at or after position, size() if none
+        size_t find_set_bit(size_t position) const noexcept
+        {
+            if (position >= items_.size())
+                return items_.size();
+
+            // climbs while the rest of the current word is empty...
+            size_t level = 0;
+            size_t index = position;
+            while (true)
+            {
+                const std::uint64_t rest = levels_[level][index / word_bits] & (~std::uint64_t(0) << (index % word_bits));
+                if (rest != 0)
+                {
+                    index = (index / word_bits) * word_bits + lowest_bit(rest);
+                    break;
+                }
+
+                index = index / word_bits + 1;
+                if (++level == levels_.size() || index >= levels_[level].size() * word_bits)
+                    return items_.size();
+            }
+
+            // ...then descends to the lowest set bit below
+            while (level-- > 0)
+                index = index * word_bits + lowest_bit(levels_[level][index]);
+
+            return index;
+        }
+
+    public:
+        using value_type = TPointer;
+        using const_iterator = typename std::vector<TPointer>::const_iterator;
+        using iterator = const_iterator; // elements cannot be changed through iterators
+
+        NullTrackingVector() = default;
+
+        explicit NullTrackingVector(size_t size)
+            : items_(size)
+        {
+            reserve_levels(size);
+            for (size_t i = 0; i < size; ++i)
+                mark(i, true);
+        }
+
+        NullTrackingVector(std::initializer_list<TPointer> items)
+            : NullTrackingVector(items.begin(), items.end())
+        {
+        }
+
+        template <typename TIterator>
+        NullTrackingVector(TIterator first, TIterator last)
+        {
+            for (; first != last; ++first)
+                push_back(*first);
+        }
+
+        size_t size() const noexcept
+        {
+            return items_.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return items_.empty();
+        }
+
+        const TPointer& operator[](size_t index) const noexcept
+        {
+            return items_[index];
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return items_.begin();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return items_.end();
+        }
+
+        void set(size_t index, TPointer value)
+        {
+            items_[index] = std::move(value);
+            mark(index, items_[index] == nullptr);
+        }
+
+        void reset(size_t index)
+        {
+            set(index, nullptr);
+        }
+
+        // moves the element out, leaving a null
+        TPointer take(size_t index)
+        {
+            TPointer result = std::move(items_[index]);
+            items_[index] = nullptr;
+            mark(index, true);
+
+            return result;
+        }
+
+        void push_back(TPointer value)
+        {
+            reserve_levels(items_.size() + 1);
+            items_.push_back(std::move(value));
+            mark(items_.size() - 1, items_.back() == nullptr);
+        }
+
+        void pop_back()
+        {
+            mark(items_.size() - 1, false);
+            items_.pop_back();
+        }
+
+        size_t null_count() const noexcept
+        {
+            return null_count_;
+        }
+
+        // size() when there are no nulls
+        size_t first_null() const noexcept
+        {
+            return find_set_bit(0);
+        }
+
+        // first null at or after position, size() when there is none
+        size_t next_null(size_t position) const noexcept
+        {
+            return find_set_bit(position);
+        }
+    };
+
+    // found by argument-dependent lookup - existing find_null(container) call sites get the O(log n) query
+
+    template <typename TPointer>
+    typename NullTrackingVector<TPointer>::const_iterator find_null(const NullTrackingVector<TPointer>& container)
+    {
+        return container.begin() + static_cast<std::ptrdiff_t>(container.first_null());
+    }
+
+    template <typename TPointer>
+    typename NullTrackingVector<TPointer>::const_iterator find_null(NullTrackingVector<TPointer>& container)
+    {
+        return container.begin() + static_cast<std::ptrdiff_t>(container.first_null());
+    }
+}
+
+#endif /*NULL_TRACKING_VECTOR_HPP_*/
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include "find_null.hpp"
+#include "null_tracking_vector.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+using null_tracking::NullTrackingVector;
+
+TEST_CASE("NullTrackingVector - queries")
+{
+    int x = 1;
+    NullTrackingVector<int*> ptrs = {&x, &x, nullptr, &x, nullptr, &x};
+
+    REQUIRE(ptrs.null_count() == 2);
+    REQUIRE(ptrs.first_null() == 2);
+    REQUIRE(ptrs.next_null(3) == 4);
+    REQUIRE(ptrs.next_null(5) == ptrs.size());
+
+    SECTION("updates on writes")
+    {
+        ptrs.set(2, &x);
+        REQUIRE(ptrs.first_null() == 4);
+
+        ptrs.reset(0);
+        REQUIRE(ptrs.first_null() == 0);
+        REQUIRE(ptrs.null_count() == 2);
+
+        ptrs.pop_back();
+        ptrs.pop_back();
+        REQUIRE(ptrs.null_count() == 1);
+    }
+
+    SECTION("plugs into the find_null overload set")
+    {
+        using namespace step_2;
+        using namespace with_std_algorithm;
+
+        // the generic templates are equally good for each other - the call compiles only because
+        // the NullTrackingVector overload found by ADL is more specialized than both
+        auto first_null_appearence = find_null(ptrs);
+        REQUIRE(distance(ptrs.begin(), first_null_appearence) == 2);
+
+        const NullTrackingVector<int*>& const_ptrs = ptrs;
+        REQUIRE(distance(const_ptrs.begin(), find_null(const_ptrs)) == 2);
+    }
+}
+
+TEST_CASE("NullTrackingVector - unique_ptrs")
+{
+    NullTrackingVector<unique_ptr<int>> owners;
+    for (int i = 0; i < 100; ++i)
+        owners.push_back(make_unique<int>(i));
+
+    REQUIRE(find_null(owners) == owners.end());
+
+    unique_ptr<int> taken = owners.take(70);
+    REQUIRE(*taken == 70);
+    REQUIRE(distance(owners.begin(), find_null(owners)) == 70);
+
+    owners.set(70, move(taken));
+    REQUIRE(owners.null_count() == 0);
+}
+
+TEST_CASE("NullTrackingVector - matches a linear scan after random writes")
+{
+    mt19937 gen {7};
+    int x = 1;
+
+    for (size_t size : {1u, 63u, 64u, 65u, 4'097u, 300'000u})
+    {
+        NullTrackingVector<int*> tracked;
+        vector<int*> plain;
+        for (size_t i = 0; i < size; ++i)
+        {
+            tracked.push_back(&x);
+            plain.push_back(&x);
+        }
+
+        uniform_int_distribution<size_t> position {0, size - 1};
+        for (int step = 0; step < 2'000; ++step)
+        {
+            const size_t i = position(gen);
+            int* value = (step % 3 == 0) ? &x : nullptr;
+            tracked.set(i, value);
+            plain[i] = value;
+
+            const size_t from = position(gen);
+            const auto expected_next = find(plain.begin() + from, plain.end(), nullptr) - plain.begin();
+            REQUIRE(tracked.next_null(from) == static_cast<size_t>(expected_next));
+        }
+
+        REQUIRE(tracked.first_null() == static_cast<size_t>(find(plain.begin(), plain.end(), nullptr) - plain.begin()));
+        REQUIRE(tracked.null_count() == static_cast<size_t>(count(plain.begin(), plain.end(), nullptr)));
+    }
+}
@@ -0,0 +1,343 @@
+#ifndef ARENA_SHAPE_GROUP_HPP_
+#define ARENA_SHAPE_GROUP_HPP_
+
+#include "paragraph.hpp"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LegacyCode
+{
+    // Paragraph whose text is allocated from a memory resource
+    class ArenaParagraph
+    {
+        std::pmr::memory_resource* resource_;
+        char* buffer_;
+        size_t length_;
+        size_t capacity_;
+
+        char* allocate(size_t capacity)
+        {
+            return static_cast<char*>(resource_->allocate(capacity + 1, alignof(char)));
+        }
+
+        void release() noexcept
+        {
+            if (buffer_ != nullptr)
+                resource_->deallocate(buffer_, capacity_ + 1, alignof(char));
+        }
+
+    public:
+        ArenaParagraph(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : ArenaParagraph("Default text!", resource)
+        {
+        }
+
+        ArenaParagraph(const char* txt, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : ArenaParagraph(txt, std::strlen(txt), resource)
+        {
+        }
+
+        ArenaParagraph(const char* txt, size_t length, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : resource_ {resource}
+            , buffer_ {allocate(length)}
+            , length_ {length}
+            , capacity_ {length}
+        {
+            std::memcpy(buffer_, txt, length);
+            buffer_[length] = '\0';
+        }
+
+        ArenaParagraph(const ArenaParagraph& other)
+            : ArenaParagraph(other.buffer_ ? other.buffer_ : "", other.length_, other.resource_)
+        {
+        }
+
+        ArenaParagraph& operator=(const ArenaParagraph& other)
+        {
+            if (this != &other)
+                set_paragraph(other.buffer_ ? other.buffer_ : "", other.length_);
+
+            return *this;
+        }
+
+        ArenaParagraph(ArenaParagraph&& other) noexcept
+            : resource_ {other.resource_}
+            , buffer_ {other.buffer_}
+            , length_ {other.length_}
+            , capacity_ {other.capacity_}
+        {
+            other.buffer_ = nullptr;
+            other.length_ = other.capacity_ = 0;
+        }
+
+        // keeps the resource of the target (as pmr containers do) - the text is copied when the resources differ
+        ArenaParagraph& operator=(ArenaParagraph&& other)
+        {
+            if (this != &other)
+            {
+                if (!resource_->is_equal(*other.resource_))
+                    return *this = other;
+
+                release();
+
+                buffer_ = other.buffer_;
+                length_ = other.length_;
+                capacity_ = other.capacity_;
+
+                other.buffer_ = nullptr;
+                other.length_ = other.capacity_ = 0;
+            }
+            return *this;
+        }
+
+        ~ArenaParagraph()
+        {
+            release();
+        }
+
+        void set_paragraph(const char* txt)
+        {
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            if (buffer_ == nullptr || length > capacity_)
+            {
+                char* new_buffer = allocate(length);
+                std::memcpy(new_buffer, txt, length);
+
+                release();
+
+                buffer_ = new_buffer;
+                capacity_ = length;
+            }
+            else
+            {
+                std::memmove(buffer_, txt, length);
+            }
+
+            buffer_[length] = '\0';
+            length_ = length;
+        }
+
+        const char* get_paragraph() const noexcept
+        {
+            return buffer_;
+        }
+
+        size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        std::pmr::memory_resource* resource() const noexcept
+        {
+            return resource_;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text(std::string_view(get_paragraph() ? get_paragraph() : "", length()), posx, posy);
+        }
+    };
+}
+
+using ArenaText = BasicText<LegacyCode::ArenaParagraph>;
+
+// shapes whose destructor only returns memory to the arena - they are never destroyed one by one
+template <typename TShape>
+struct is_arena_disposable : std::false_type
+{
+};
+
+template <>
+struct is_arena_disposable<ArenaText> : std::true_type
+{
+};
+
+// Move-only group whose children and their texts are allocated from one monotonic arena
+// - shapes that can take a memory resource as the last constructor argument get the arena
+// - disposable children are not destroyed one by one; the whole arena is released at once
+// - changes of children mark the whole group dirty; render_incremental() then renders all of them
+class ArenaShapeGroup : public Shape
+{
+    struct Scene
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<Shape*> shapes {&arena};
+        std::pmr::vector<Shape*> destructibles {&arena};
+        std::pmr::vector<std::unique_ptr<Shape>> heap_shapes {&arena};
+
+        Scene(size_t initial_size, std::pmr::memory_resource* upstream)
+            : arena {initial_size, upstream}
+        {
+        }
+
+        ~Scene()
+        {
+            for (auto it = destructibles.rbegin(); it != destructibles.rend(); ++it)
+                (*it)->~Shape();
+        }
+    };
+
+    size_t initial_size_;
+    std::pmr::memory_resource* upstream_;
+    std::unique_ptr<Scene> scene_;
+
+    Scene& scene()
+    {
+        if (!scene_)
+            scene_ = std::make_unique<Scene>(initial_size_, upstream_);
+
+        return *scene_;
+    }
+
+    void adopt_children() noexcept
+    {
+        if (scene_)
+        {
+            for (Shape* s : scene_->shapes)
+                adopt(*s);
+        }
+    }
+
+public:
+    explicit ArenaShapeGroup(size_t initial_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : initial_size_ {initial_size}
+        , upstream_ {upstream}
+        , scene_ {std::make_unique<Scene>(initial_size, upstream)}
+    {
+    }
+
+    ArenaShapeGroup(const ArenaShapeGroup&) = delete;
+    ArenaShapeGroup& operator=(const ArenaShapeGroup&) = delete;
+
+    ArenaShapeGroup(ArenaShapeGroup&& other) noexcept
+        : Shape(other)
+        , initial_size_ {other.initial_size_}
+        , upstream_ {other.upstream_}
+        , scene_ {std::move(other.scene_)}
+    {
+        adopt_children();
+        other.bump_revision();
+    }
+
+    ArenaShapeGroup& operator=(ArenaShapeGroup&& other) noexcept
+    {
+        if (this != &other)
+        {
+            initial_size_ = other.initial_size_;
+            upstream_ = other.upstream_;
+            scene_ = std::move(other.scene_);
+            adopt_children();
+            mark_dirty();
+            other.bump_revision();
+        }
+        return *this;
+    }
+
+    template <typename TShape, typename... TArgs>
+    TShape& emplace(TArgs&&... args)
+    {
+        static_assert(std::is_base_of_v<Shape, TShape>, "ArenaShapeGroup holds only shapes");
+        constexpr bool uses_arena = std::is_constructible_v<TShape, TArgs..., std::pmr::memory_resource*>;
+
+        Scene& s = scene();
+        s.shapes.reserve(s.shapes.size() + 1);
+
+        void* raw_mem = s.arena.allocate(sizeof(TShape), alignof(TShape));
+        TShape* shape;
+        if constexpr (uses_arena)
+            shape = new (raw_mem) TShape(std::forward<TArgs>(args)..., &s.arena);
+        else
+            shape = new (raw_mem) TShape(std::forward<TArgs>(args)...);
+
+        if constexpr (!(uses_arena && is_arena_disposable<TShape>::value))
+        {
+            try
+            {
+                s.destructibles.push_back(shape);
+            }
+            catch (...)
+            {
+                shape->~TShape();
+                throw;
+            }
+        }
+
+        s.shapes.push_back(shape);
+        adopt(*shape);
+        mark_dirty();
+
+        return *shape;
+    }
+
+    ArenaText& add_text(int x, int y, std::string_view text)
+    {
+        return emplace<ArenaText>(x, y, text);
+    }
+
+    // shapes created outside of the arena are kept and destroyed as in ShapeGroup
+    void add(std::unique_ptr<Shape> shape)
+    {
+        Scene& s = scene();
+        s.shapes.reserve(s.shapes.size() + 1);
+        s.heap_shapes.push_back(std::move(shape));
+        s.shapes.push_back(s.heap_shapes.back().get());
+        adopt(*s.shapes.back());
+        mark_dirty();
+    }
+
+    size_t size() const noexcept
+    {
+        return scene_ ? scene_->shapes.size() : 0;
+    }
+
+    const Shape& operator[](size_t index) const
+    {
+        return *scene_->shapes[index];
+    }
+
+    void render(RenderBuffer& frame) const override
+    {
+        if (!scene_)
+            return;
+
+        for (const Shape* s : scene_->shapes)
+            s->render(frame);
+    }
+
+    bool visit_children(const std::function<void(const Shape&)>& visitor) const override
+    {
+        if (scene_)
+        {
+            for (const Shape* s : scene_->shapes)
+                visitor(*s);
+        }
+
+        return true;
+    }
+
+    void render_incremental(RenderBuffer& frame) override
+    {
+        if (!is_dirty())
+            return;
+
+        render(frame);
+        if (scene_)
+        {
+            for (Shape* s : scene_->shapes)
+                mark_rendered(*s);
+        }
+        clear_dirty();
+    }
+};
+
+#endif /*ARENA_SHAPE_GROUP_HPP_*/
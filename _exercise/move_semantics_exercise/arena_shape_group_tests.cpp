@@ -0,0 +1,144 @@
+#include "arena_shape_group.hpp"
+#include "catch.hpp"
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    class CountingResource : public std::pmr::memory_resource
+    {
+        std::pmr::memory_resource* upstream_ = std::pmr::new_delete_resource();
+
+    public:
+        size_t allocations = 0;
+        size_t deallocations = 0;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++allocations;
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            ++deallocations;
+            upstream_->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    struct CountedShape : Shape
+    {
+        static inline int alive = 0;
+
+        CountedShape()
+        {
+            ++alive;
+        }
+
+        ~CountedShape()
+        {
+            --alive;
+        }
+
+        void render(RenderBuffer&) const override
+        {
+        }
+    };
+}
+
+TEST_CASE("ArenaParagraph - move assignment keeps the target's resource")
+{
+    CountingResource first, second;
+
+    LegacyCode::ArenaParagraph target {"target", &first};
+    LegacyCode::ArenaParagraph same {"same resource", &first};
+    LegacyCode::ArenaParagraph other {"other resource", &second};
+
+    const char* stolen = same.get_paragraph();
+    target = move(same);
+    REQUIRE(target.get_paragraph() == stolen);
+    REQUIRE(same.get_paragraph() == nullptr);
+
+    const size_t allocations = first.allocations;
+    target = move(other);
+    REQUIRE(target.resource() == &first);
+    REQUIRE(target.get_paragraph() == "other resource"s);
+    REQUIRE(first.allocations == allocations + 1);
+    REQUIRE(second.allocations == 1);
+}
+
+TEST_CASE("ArenaShapeGroup - children come from the arena")
+{
+    CountingResource upstream;
+
+    {
+        ArenaShapeGroup sg {64 * 1024, &upstream};
+
+        for (int i = 0; i < 1000; ++i)
+            sg.add_text(i, i, "label-" + to_string(i));
+
+        REQUIRE(sg.size() == 1000);
+        REQUIRE(upstream.allocations < 10);
+
+        auto& txt = sg.emplace<ArenaText>(1, 2, "short");
+        txt.set_text(string(500, 'x'));
+        REQUIRE(txt.text() == string(500, 'x'));
+    }
+
+    REQUIRE(upstream.deallocations == upstream.allocations);
+}
+
+TEST_CASE("ArenaShapeGroup - draw and move")
+{
+    ArenaShapeGroup sg;
+    sg.add_text(10, 20, "arena text");
+    sg.add(make_unique<Text>(30, 40, "heap text"));
+    sg.emplace<CountedShape>();
+
+    ArenaShapeGroup moved = move(sg);
+    REQUIRE(sg.size() == 0);
+    REQUIRE(moved.size() == 3);
+    REQUIRE(CountedShape::alive == 1);
+
+    ostringstream out;
+    auto* old_buffer = cout.rdbuf(out.rdbuf());
+    moved.draw();
+    cout.rdbuf(old_buffer);
+
+    REQUIRE(out.str() == "Rendering text 'arena text' at: [10, 20]\nRendering text 'heap text' at: [30, 40]\n");
+
+    moved = ArenaShapeGroup {};
+    REQUIRE(CountedShape::alive == 0);
+}
+
+TEST_CASE("ArenaShapeGroup - changes of children reach enclosing groups")
+{
+    ShapeGroup scene;
+    auto group = make_unique<ArenaShapeGroup>();
+    ArenaText& txt = group->add_text(1, 2, "arena text");
+    scene.add(move(group));
+
+    RenderBuffer frame;
+    scene.render_incremental(frame);
+    frame.clear();
+
+    scene.render_incremental(frame);
+    REQUIRE(frame.empty());
+
+    const auto revision = scene.revision();
+    txt.move_to(3, 4);
+    REQUIRE(scene.revision() > revision);
+
+    scene.render_incremental(frame);
+    REQUIRE(frame.str() == "Rendering text 'arena text' at: [3, 4]\n");
+}
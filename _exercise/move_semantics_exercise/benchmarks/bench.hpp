@@ -0,0 +1,82 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    template <typename T>
+    void do_not_optimize(const T& value)
+    {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+    // best of a few runs, in nanoseconds
+    template <typename TFunction>
+    double measure_ns(TFunction&& f, int repetitions = 5)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            const auto start = Clock::now();
+            f();
+            const auto stop = Clock::now();
+
+            const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+            best = (i == 0) ? elapsed : std::min(best, elapsed);
+        }
+
+        return best;
+    }
+
+    inline void report(const std::string& name, double total_ns, size_t ops)
+    {
+        std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << total_ns / 1e6 << " ms" << std::setw(12) << total_ns / ops << " ns/op\n";
+    }
+
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int_type overflow(int_type c) override
+        {
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char_type*, std::streamsize n) override
+        {
+            return n;
+        }
+    };
+
+    // discards everything written to std::cout while alive
+    class SilenceCout
+    {
+        NullBuffer null_buffer_;
+        std::streambuf* original_;
+
+    public:
+        SilenceCout()
+            : original_ {std::cout.rdbuf(&null_buffer_)}
+        {
+        }
+
+        SilenceCout(const SilenceCout&) = delete;
+        SilenceCout& operator=(const SilenceCout&) = delete;
+
+        ~SilenceCout()
+        {
+            std::cout.rdbuf(original_);
+        }
+    };
+}
+
+#endif /*BENCH_HPP_*/
@@ -0,0 +1,60 @@
+#include "../display_list.hpp"
+#include "bench.hpp"
+
+#include <memory>
+#include <string>
+
+// Shape::render of a nested scene vs rendering its compiled DisplayList
+
+namespace
+{
+    // groups nested `depth` levels deep, every level holds a few texts
+    void fill(ShapeGroup& group, int depth, int texts_per_level)
+    {
+        for (int i = 0; i < texts_per_level; ++i)
+            group.add(std::make_unique<Text>(depth, i, "label-" + std::to_string(i)));
+
+        if (depth > 0)
+        {
+            for (int branch = 0; branch < 2; ++branch)
+            {
+                auto child = std::make_unique<ShapeGroup>();
+                fill(*child, depth - 1, texts_per_level);
+                group.add(std::move(child));
+            }
+        }
+    }
+}
+
+int main()
+{
+    constexpr int depth = 14;
+    constexpr int texts_per_level = 4;
+
+    ShapeGroup scene;
+    fill(scene, depth, texts_per_level);
+
+    DisplayList list {scene};
+    const size_t item_count = list.items().size();
+    std::cout << "Scene: " << item_count << " texts in groups nested " << depth << " levels deep\n";
+
+    const double tree_ns = Bench::measure_ns([&] {
+        RenderBuffer frame;
+        scene.render(frame);
+        Bench::do_not_optimize(frame);
+    });
+    Bench::report("Shape::render (tree walk)", tree_ns, item_count);
+
+    const double list_ns = Bench::measure_ns([&] {
+        RenderBuffer frame;
+        list.render(frame);
+        Bench::do_not_optimize(frame);
+    });
+    Bench::report("DisplayList::render (cached)", list_ns, item_count);
+
+    const double compile_ns = Bench::measure_ns([&] {
+        list.invalidate();
+        list.update();
+    });
+    Bench::report("DisplayList compilation", compile_ns, item_count);
+}
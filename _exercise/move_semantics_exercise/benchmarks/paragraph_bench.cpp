@@ -0,0 +1,255 @@
+#include "../paragraph.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Copy/move costs of Paragraph and Text across text lengths and object counts
+// usage: paragraph_bench [results.json]
+
+namespace
+{
+    std::atomic<size_t> allocation_count {0};
+    std::atomic<size_t> allocated_bytes {0};
+}
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    struct Result
+    {
+        std::string operation;
+        std::string type;
+        size_t text_length;
+        size_t count;
+        double ns_per_op;
+        double allocs_per_op;
+        double bytes_per_op;
+        double slab_blocks_per_op;
+    };
+
+    // Paragraph buffers up to 4 KiB come from the SlabAllocator and never reach operator new
+    size_t slab_blocks_served()
+    {
+        const LegacyCode::SlabStats stats = LegacyCode::SlabAllocator::instance().stats();
+        return stats.thread_cache_hits + stats.shared_pool_hits;
+    }
+
+    std::vector<Result> results;
+
+    // setup() returns the state, run(state) performs count operations - only run() is measured
+    template <typename TSetup, typename TRun>
+    void measure(const std::string& operation, const std::string& type, size_t text_length, size_t count, TSetup setup, TRun run)
+    {
+        constexpr int repetitions = 3;
+
+        double best_ns = 0.0;
+        size_t allocs = 0, bytes = 0, slab_blocks = 0;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto state = setup();
+
+            const size_t allocs_before = allocation_count.load();
+            const size_t bytes_before = allocated_bytes.load();
+            const size_t slab_blocks_before = slab_blocks_served();
+            const auto start = Bench::Clock::now();
+
+            run(state);
+
+            const auto stop = Bench::Clock::now();
+            allocs = allocation_count.load() - allocs_before;
+            bytes = allocated_bytes.load() - bytes_before;
+            slab_blocks = slab_blocks_served() - slab_blocks_before;
+
+            Bench::do_not_optimize(state);
+
+            const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+            best_ns = (i == 0) ? elapsed : std::min(best_ns, elapsed);
+        }
+
+        results.push_back({operation, type, text_length, count, best_ns / count, double(allocs) / count, double(bytes) / count, double(slab_blocks) / count});
+
+        const Result& r = results.back();
+        std::cout << std::left << std::setw(20) << operation << std::setw(11) << type << std::right
+                  << std::setw(8) << text_length << std::setw(10) << count << std::fixed << std::setprecision(2)
+                  << std::setw(12) << r.ns_per_op << std::setw(12) << r.allocs_per_op << std::setw(14) << r.bytes_per_op << std::setw(14) << r.slab_blocks_per_op << "\n";
+    }
+
+    template <typename T>
+    std::vector<T> make_objects(size_t count, const std::string& text);
+
+    template <>
+    std::vector<LegacyCode::Paragraph> make_objects(size_t count, const std::string& text)
+    {
+        return std::vector<LegacyCode::Paragraph>(count, LegacyCode::Paragraph(text.c_str(), text.size()));
+    }
+
+    template <>
+    std::vector<Text> make_objects(size_t count, const std::string& text)
+    {
+        return std::vector<Text>(count, Text(0, 0, text));
+    }
+
+    template <typename T>
+    void set_text(T& object, const std::string& text);
+
+    template <>
+    void set_text(LegacyCode::Paragraph& p, const std::string& text)
+    {
+        p.set_paragraph(text.c_str(), text.size());
+    }
+
+    template <>
+    void set_text(Text& t, const std::string& text)
+    {
+        t.set_text(text);
+    }
+
+    template <typename T>
+    void benchmark_type(const std::string& type, size_t text_length, size_t count)
+    {
+        const std::string text(text_length, 'x');
+        const std::string other_text(text_length, 'y');
+
+        struct Buffers
+        {
+            std::vector<T> sources;
+            std::vector<T> targets;
+        };
+
+        // targets are reserved up front, so the vector itself does not allocate in the measured loop
+        auto sources_only = [&] {
+            Buffers b {make_objects<T>(count, text), {}};
+            b.targets.reserve(count);
+            return b;
+        };
+        auto sources_and_targets = [&] { return Buffers {make_objects<T>(count, text), make_objects<T>(count, other_text)}; };
+
+        measure("copy construction", type, text_length, count, sources_only, [](Buffers& b) {
+            for (const auto& s : b.sources)
+                b.targets.emplace_back(s);
+        });
+
+        measure("move construction", type, text_length, count, sources_only, [](Buffers& b) {
+            for (auto& s : b.sources)
+                b.targets.emplace_back(std::move(s));
+        });
+
+        measure("copy assignment", type, text_length, count, sources_and_targets, [](Buffers& b) {
+            for (size_t i = 0; i < b.sources.size(); ++i)
+                b.targets[i] = b.sources[i];
+        });
+
+        measure("move assignment", type, text_length, count, sources_and_targets, [](Buffers& b) {
+            for (size_t i = 0; i < b.sources.size(); ++i)
+                b.targets[i] = std::move(b.sources[i]);
+        });
+
+        measure("set_paragraph", type, text_length, count, sources_only, [&other_text](Buffers& b) {
+            for (auto& s : b.sources)
+                set_text(s, other_text);
+        });
+    }
+
+    void benchmark_shape_group(size_t text_length, size_t count)
+    {
+        const std::string text(text_length, 'x');
+
+        auto texts = [&] {
+            std::vector<std::unique_ptr<Shape>> shapes;
+            shapes.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                shapes.push_back(std::make_unique<Text>(static_cast<int>(i), 0, text));
+
+            return std::make_pair(std::move(shapes), ShapeGroup {});
+        };
+
+        measure("ShapeGroup::add", "Text", text_length, count, texts, [](auto& state) {
+            for (auto& s : state.first)
+                state.second.add(std::move(s));
+        });
+
+        auto group = [&] {
+            auto state = texts();
+            for (auto& s : state.first)
+                state.second.add(std::move(s));
+
+            return state;
+        };
+
+        measure("ShapeGroup::draw", "Text", text_length, count, group, [](auto& state) {
+            Bench::SilenceCout silence;
+            state.second.draw();
+        });
+    }
+
+    void write_json(const std::string& path)
+    {
+        std::ofstream out(path);
+        out << "{\n  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            out << "    {\"operation\": \"" << r.operation << "\", \"type\": \"" << r.type << "\", \"text_length\": " << r.text_length
+                << ", \"count\": " << r.count << ", \"ns_per_op\": " << r.ns_per_op << ", \"allocs_per_op\": " << r.allocs_per_op
+                << ", \"bytes_per_op\": " << r.bytes_per_op << ", \"slab_blocks_per_op\": " << r.slab_blocks_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string json_path = (argc > 1) ? argv[1] : "paragraph_bench.json";
+
+    std::cout << std::left << std::setw(20) << "operation" << std::setw(11) << "type" << std::right << std::setw(8) << "length"
+              << std::setw(10) << "count" << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(14) << "bytes/op" << std::setw(14) << "slab blks/op" << "\n";
+
+    for (size_t count : {1'000, 100'000})
+    {
+        for (size_t text_length : {3, 15, 64, 1'000, 10'000})
+        {
+            if (text_length * count > 100'000'000)
+                continue;
+
+            benchmark_type<LegacyCode::Paragraph>("Paragraph", text_length, count);
+            benchmark_type<Text>("Text", text_length, count);
+            benchmark_shape_group(text_length, count);
+        }
+    }
+
+    write_json(json_path);
+    std::cout << "\nResults written to " << json_path << "\n";
+}
@@ -0,0 +1,44 @@
+#include "../parallel_draw.hpp"
+#include "bench.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+// render_parallel scaling from 1 to N threads
+
+int main()
+{
+    constexpr int group_count = 100;
+    constexpr int texts_per_group = 5000;
+    constexpr size_t shape_count = group_count * texts_per_group;
+
+    ShapeGroup scene;
+    for (int g = 0; g < group_count; ++g)
+    {
+        auto group = std::make_unique<ShapeGroup>();
+        for (int i = 0; i < texts_per_group; ++i)
+            group->add(std::make_unique<Text>(g, i, "label-" + std::to_string(i)));
+
+        scene.add(std::move(group));
+    }
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "Rendering " << shape_count << " shapes, hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    double single_thread_ns = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const double ns = Bench::measure_ns([&] {
+            RenderBuffer frame;
+            render_parallel(scene, frame, threads);
+            Bench::do_not_optimize(frame);
+        });
+
+        if (threads == 1)
+            single_thread_ns = ns;
+
+        Bench::report("render_parallel - " + std::to_string(threads) + " thread(s)", ns, shape_count);
+        std::cout << "    speedup: " << single_thread_ns / ns << "x\n";
+    }
+}
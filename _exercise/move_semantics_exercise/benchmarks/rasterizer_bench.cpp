@@ -0,0 +1,39 @@
+#include "../rasterizer.hpp"
+#include "bench.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+// Rasterizer throughput in glyphs per second, 1 to N threads
+
+int main()
+{
+    constexpr int width = 1920;
+    constexpr int height = 1080;
+    constexpr int text_count = 100'000;
+
+    ShapeGroup scene;
+    for (int i = 0; i < text_count; ++i)
+        scene.add(std::make_unique<Text>((i * 97) % (width - 64), (i * 31) % (height - 8), "label-" + std::to_string(i)));
+
+    DisplayList list {scene};
+    Framebuffer frame {width, height};
+    const Rasterizer rasterizer;
+
+    const size_t glyph_count = rasterizer.rasterize(list, frame, 1);
+    std::cout << "Rasterizing " << glyph_count << " glyphs into " << width << "x" << height
+              << ", hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const double ns = Bench::measure_ns([&] {
+            rasterizer.rasterize(list, frame, threads);
+            Bench::do_not_optimize(frame);
+        });
+
+        Bench::report("rasterize - " + std::to_string(threads) + " thread(s)", ns, glyph_count);
+        std::cout << "    " << std::setprecision(1) << glyph_count / (ns / 1e9) / 1e6 << " M glyphs/s\n";
+    }
+}
@@ -0,0 +1,58 @@
+#include "../scene_file.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// loading a scene from a mapped SceneFile vs building it by hand
+
+namespace
+{
+    constexpr int group_count = 100;
+    constexpr int texts_per_group = 10'000;
+
+    ShapeGroup build_scene()
+    {
+        ShapeGroup scene;
+        for (int g = 0; g < group_count; ++g)
+        {
+            auto group = std::make_unique<ShapeGroup>();
+            for (int i = 0; i < texts_per_group; ++i)
+                group->add(std::make_unique<Text>(g, i, "label number " + std::to_string(i)));
+
+            scene.add(std::move(group));
+        }
+
+        return scene;
+    }
+}
+
+int main()
+{
+#ifdef SCENE_FILE_HAS_MMAP
+    const std::string path = (std::filesystem::temp_directory_path() / "scene_file_bench.bin").string();
+    SceneFile::write(build_scene(), path);
+
+    constexpr size_t shape_count = group_count * texts_per_group;
+    std::cout << "Scene: " << shape_count << " texts, file size: " << std::filesystem::file_size(path) / 1024 << " KiB\n";
+
+    const double build_ns = Bench::measure_ns([] {
+        ShapeGroup scene = build_scene();
+        Bench::do_not_optimize(scene);
+    });
+
+    const double load_ns = Bench::measure_ns([&path] {
+        SceneFile::MappedScene scene {path};
+        Bench::do_not_optimize(scene);
+    });
+
+    Bench::report("build by hand (incl. teardown)", build_ns, shape_count);
+    Bench::report("MappedScene load (incl. teardown)", load_ns, shape_count);
+
+    std::remove(path.c_str());
+#else
+    std::cout << "SceneFile mapping is not available on this platform\n";
+#endif
+}
@@ -0,0 +1,69 @@
+#include "../paragraph.hpp"
+#include "../static_shape_group.hpp"
+#include "../text_pool.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+
+// ShapeGroup (vector<unique_ptr<Shape>> + virtual draw) vs StaticShapeGroup (arrays per type + static dispatch)
+
+int main()
+{
+    constexpr size_t shape_count = 1'000'000;
+    const std::string labels[] = {"label", "another label", "a long label that does not fit inline"};
+
+    ShapeGroup heap_group;
+    StaticShapeGroup<Text, InternedText> static_group;
+    static_group.reserve<Text>(shape_count / 2);
+    static_group.reserve<InternedText>(shape_count / 2);
+
+    for (size_t i = 0; i < shape_count; ++i)
+    {
+        const int x = static_cast<int>(i % 1000);
+        const int y = static_cast<int>(i / 1000);
+        const std::string& label = labels[i % 3];
+
+        if (i % 2 == 0)
+        {
+            heap_group.add(std::make_unique<Text>(x, y, label));
+            static_group.emplace<Text>(x, y, label);
+        }
+        else
+        {
+            heap_group.add(std::make_unique<InternedText>(x, y, label));
+            static_group.emplace<InternedText>(x, y, label);
+        }
+    }
+
+    // the same pointers in random order - models a scene built up over time
+    ShapeGroup scattered_group;
+    {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        for (size_t i = 0; i < shape_count; ++i)
+            shapes.push_back(i % 2 == 0 ? std::unique_ptr<Shape>(std::make_unique<Text>(1, 2, labels[i % 3]))
+                                        : std::unique_ptr<Shape>(std::make_unique<InternedText>(1, 2, labels[i % 3])));
+
+        std::shuffle(shapes.begin(), shapes.end(), std::mt19937 {42});
+        for (auto& s : shapes)
+            scattered_group.add(std::move(s));
+    }
+
+    std::cout << "Rendering " << shape_count << " shapes into a frame\n";
+
+    auto render = [](const Shape& group) {
+        RenderBuffer frame;
+        group.render(frame);
+        Bench::do_not_optimize(frame);
+    };
+
+    const double heap_ns = Bench::measure_ns([&] { render(heap_group); });
+    const double scattered_ns = Bench::measure_ns([&] { render(scattered_group); });
+    const double static_ns = Bench::measure_ns([&] { render(static_group); });
+
+    Bench::report("ShapeGroup::render", heap_ns, shape_count);
+    Bench::report("ShapeGroup::render (scattered heap)", scattered_ns, shape_count);
+    Bench::report("StaticShapeGroup<Text, InternedText>::render", static_ns, shape_count);
+}
@@ -0,0 +1,215 @@
+#ifndef COW_PARAGRAPH_HPP_
+#define COW_PARAGRAPH_HPP_
+
+#include "paragraph.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace LegacyCode
+{
+    namespace RefCount
+    {
+        struct SingleThreaded
+        {
+            using counter_type = size_t;
+
+            static void increment(counter_type& counter) noexcept
+            {
+                ++counter;
+            }
+
+            // returns true when the last reference was released
+            static bool decrement(counter_type& counter) noexcept
+            {
+                return --counter == 0;
+            }
+
+            static size_t load(const counter_type& counter) noexcept
+            {
+                return counter;
+            }
+        };
+
+        struct MultiThreaded
+        {
+            using counter_type = std::atomic<size_t>;
+
+            static void increment(counter_type& counter) noexcept
+            {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            static bool decrement(counter_type& counter) noexcept
+            {
+                return counter.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            static size_t load(const counter_type& counter) noexcept
+            {
+                return counter.load(std::memory_order_acquire);
+            }
+        };
+    }
+
+    // Paragraph whose copies share one immutable, reference-counted buffer;
+    // only set_paragraph() on a shared buffer makes a private copy
+    template <typename TRefCountPolicy>
+    class BasicCowParagraph
+    {
+        struct SharedBuffer
+        {
+            typename TRefCountPolicy::counter_type ref_count;
+            size_t length;
+            size_t capacity;
+
+            SharedBuffer(size_t len, size_t cap)
+                : ref_count {1}
+                , length {len}
+                , capacity {cap}
+            {
+            }
+
+            char* text() noexcept
+            {
+                return reinterpret_cast<char*>(this + 1);
+            }
+        };
+
+        SharedBuffer* buffer_;
+
+        static SharedBuffer* create(const char* txt, size_t length)
+        {
+            void* raw_mem = ::operator new(sizeof(SharedBuffer) + length + 1);
+            SharedBuffer* buffer = new (raw_mem) SharedBuffer(length, length);
+
+            std::memcpy(buffer->text(), txt, length);
+            buffer->text()[length] = '\0';
+
+            return buffer;
+        }
+
+        static void release(SharedBuffer* buffer) noexcept
+        {
+            if (buffer != nullptr && TRefCountPolicy::decrement(buffer->ref_count))
+            {
+                buffer->~SharedBuffer();
+                ::operator delete(buffer);
+            }
+        }
+
+    public:
+        BasicCowParagraph()
+            : BasicCowParagraph("Default text!")
+        {
+        }
+
+        BasicCowParagraph(const char* txt)
+            : BasicCowParagraph(txt, std::strlen(txt))
+        {
+        }
+
+        BasicCowParagraph(const char* txt, size_t length)
+            : buffer_ {create(txt, length)}
+        {
+        }
+
+        BasicCowParagraph(const BasicCowParagraph& other) noexcept
+            : buffer_ {other.buffer_}
+        {
+            if (buffer_ != nullptr)
+                TRefCountPolicy::increment(buffer_->ref_count);
+        }
+
+        BasicCowParagraph& operator=(const BasicCowParagraph& other) noexcept
+        {
+            BasicCowParagraph temp(other);
+            swap(temp);
+
+            return *this;
+        }
+
+        BasicCowParagraph(BasicCowParagraph&& other) noexcept
+            : buffer_ {other.buffer_}
+        {
+            other.buffer_ = nullptr;
+        }
+
+        BasicCowParagraph& operator=(BasicCowParagraph&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release(buffer_);
+
+                buffer_ = other.buffer_;
+                other.buffer_ = nullptr;
+            }
+            return *this;
+        }
+
+        ~BasicCowParagraph()
+        {
+            release(buffer_);
+        }
+
+        void swap(BasicCowParagraph& other) noexcept
+        {
+            std::swap(buffer_, other.buffer_);
+        }
+
+        void set_paragraph(const char* txt)
+        {
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            if (is_unique() && length <= buffer_->capacity)
+            {
+                std::memmove(buffer_->text(), txt, length);
+                buffer_->text()[length] = '\0';
+                buffer_->length = length;
+            }
+            else
+            {
+                SharedBuffer* private_copy = create(txt, length);
+                release(buffer_);
+                buffer_ = private_copy;
+            }
+        }
+
+        const char* get_paragraph() const noexcept
+        {
+            return buffer_ ? buffer_->text() : nullptr;
+        }
+
+        size_t length() const noexcept
+        {
+            return buffer_ ? buffer_->length : 0;
+        }
+
+        size_t use_count() const noexcept
+        {
+            return buffer_ ? TRefCountPolicy::load(buffer_->ref_count) : 0;
+        }
+
+        bool is_unique() const noexcept
+        {
+            return use_count() == 1;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text(std::string_view(get_paragraph() ? get_paragraph() : "", length()), posx, posy);
+        }
+    };
+
+    using CowParagraph = BasicCowParagraph<RefCount::SingleThreaded>;
+    using ThreadSafeCowParagraph = BasicCowParagraph<RefCount::MultiThreaded>;
+}
+
+using CowText = BasicText<LegacyCode::CowParagraph>;
+using ThreadSafeCowText = BasicText<LegacyCode::ThreadSafeCowParagraph>;
+
+#endif /*COW_PARAGRAPH_HPP_*/
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "cow_paragraph.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("CowParagraph - copies share buffer")
+{
+    LegacyCode::CowParagraph p("shared text");
+    LegacyCode::CowParagraph cp = p;
+
+    REQUIRE(cp.get_paragraph() == p.get_paragraph());
+    REQUIRE(p.use_count() == 2);
+
+    SECTION("set_paragraph makes a private copy")
+    {
+        cp.set_paragraph("changed");
+
+        REQUIRE(p.get_paragraph() == string("shared text"));
+        REQUIRE(cp.get_paragraph() == string("changed"));
+        REQUIRE(p.use_count() == 1);
+        REQUIRE(cp.use_count() == 1);
+    }
+
+    SECTION("unique owner writes in place")
+    {
+        cp = LegacyCode::CowParagraph("other");
+        const char* buffer = p.get_paragraph();
+
+        p.set_paragraph("shorter");
+
+        REQUIRE(p.get_paragraph() == buffer);
+        REQUIRE(p.get_paragraph() == string("shorter"));
+        REQUIRE(p.length() == 7);
+    }
+
+    SECTION("move leaves empty paragraph")
+    {
+        LegacyCode::CowParagraph mp = move(cp);
+
+        REQUIRE(cp.get_paragraph() == nullptr);
+        REQUIRE(mp.get_paragraph() == string("shared text"));
+        REQUIRE(p.use_count() == 2);
+    }
+}
+
+TEST_CASE("CowText - copy and modify")
+{
+    CowText txt {10, 20, "label"};
+    CowText copy = txt;
+
+    REQUIRE(copy.paragraph().use_count() == 2);
+
+    copy.set_text("other label");
+
+    REQUIRE(txt.text() == "label"s);
+    REQUIRE(copy.text() == "other label"s);
+
+    CowText mtxt = move(txt);
+    REQUIRE(txt.text() == string());
+}
+
+TEST_CASE("ThreadSafeCowText - copies from many threads")
+{
+    const ThreadSafeCowText original {1, 2, "shared scene label"};
+
+    vector<thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&original] {
+            vector<ThreadSafeCowText> copies(1000, original);
+            copies.back().set_text("private");
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(original.paragraph().use_count() == 1);
+    REQUIRE(original.text() == "shared scene label"s);
+}
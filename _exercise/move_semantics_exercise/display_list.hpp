@@ -0,0 +1,123 @@
+#ifndef DISPLAY_LIST_HPP_
+#define DISPLAY_LIST_HPP_
+
+#include "paragraph.hpp"
+#include "render_sink.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+// One command of a compiled scene - a text at its position,
+// or a shape that cannot be flattened and is rendered through Shape::render()
+struct DisplayItem
+{
+    const Shape* opaque; // nullptr for text items
+    std::string_view text;
+    Point position;
+};
+
+// Scene flattened into a linear list of draw commands
+// - nested groups (see Shape::visit_children) are expanded in drawing order, text shapes are reduced to (text, position)
+// - the list is recompiled only when the revision of the root has changed
+// - the root must outlive the display list
+class DisplayList
+{
+    const Shape* root_;
+    std::vector<DisplayItem> items_;
+    std::uint64_t compiled_revision_ = 0;
+    bool compiled_ = false;
+    size_t compilation_count_ = 0;
+
+    void compile()
+    {
+        items_.clear();
+
+        std::vector<const Shape*> pending {root_}; // explicit stack - deep trees do not recurse
+        std::vector<const Shape*> children;
+        while (!pending.empty())
+        {
+            const Shape* shape = pending.back();
+            pending.pop_back();
+
+            children.clear();
+            if (shape->visit_children([&children](const Shape& child) { children.push_back(&child); }))
+            {
+                pending.insert(pending.end(), children.rbegin(), children.rend());
+                continue;
+            }
+
+            const auto* text = dynamic_cast<const TextShape*>(shape);
+            const auto position = shape->anchor();
+
+            if (text != nullptr && position)
+                items_.push_back(DisplayItem {nullptr, text->text_view(), *position});
+            else
+                items_.push_back(DisplayItem {shape, {}, {}});
+        }
+
+        compiled_revision_ = root_->revision();
+        compiled_ = true;
+        ++compilation_count_;
+    }
+
+public:
+    explicit DisplayList(const Shape& root)
+        : root_ {&root}
+    {
+    }
+
+    bool is_stale() const noexcept
+    {
+        return !compiled_ || compiled_revision_ != root_->revision();
+    }
+
+    void invalidate() noexcept
+    {
+        compiled_ = false;
+    }
+
+    // recompiles the list if the scene has changed
+    void update()
+    {
+        if (is_stale())
+            compile();
+    }
+
+    const std::vector<DisplayItem>& items()
+    {
+        update();
+        return items_;
+    }
+
+    size_t compilation_count() const noexcept
+    {
+        return compilation_count_;
+    }
+
+    // output is identical to root.render(frame)
+    void render(RenderBuffer& frame)
+    {
+        update();
+
+        for (const DisplayItem& item : items_)
+        {
+            if (item.opaque == nullptr)
+                frame.render_text(item.text, item.position.x, item.position.y);
+            else
+                item.opaque->render(frame);
+        }
+    }
+
+    void draw()
+    {
+        RenderBuffer frame;
+        render(frame);
+
+        OstreamSink sink {std::cout};
+        frame.submit(sink);
+    }
+};
+
+#endif /*DISPLAY_LIST_HPP_*/
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include "cow_paragraph.hpp"
+#include "display_list.hpp"
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    struct Marker : Shape
+    {
+        void render(RenderBuffer& frame) const override
+        {
+            frame.append("marker\n");
+        }
+    };
+
+    string rendered(const Shape& shape)
+    {
+        RenderBuffer frame;
+        shape.render(frame);
+        return frame.str();
+    }
+
+    string rendered(DisplayList& list)
+    {
+        RenderBuffer frame;
+        list.render(frame);
+        return frame.str();
+    }
+}
+
+TEST_CASE("DisplayList - flattens nested groups")
+{
+    ShapeGroup scene;
+    scene.add(make_unique<Text>(1, 2, "first"));
+
+    auto group = make_unique<ShapeGroup>();
+    group->add(make_unique<CowText>(3, 4, "nested"));
+    group->add(make_unique<Marker>());
+    scene.add(move(group));
+    scene.add(make_unique<Text>(5, 6, "last"));
+
+    DisplayList list {scene};
+
+    REQUIRE(list.items().size() == 4);
+    REQUIRE(list.items()[1].text == "nested");
+    REQUIRE(list.items()[1].position.x == 3);
+    REQUIRE(list.items()[2].opaque != nullptr);
+    REQUIRE(rendered(list) == rendered(scene));
+}
+
+TEST_CASE("DisplayList - recompiles only after changes")
+{
+    ShapeGroup scene;
+    auto group = make_unique<ShapeGroup>();
+    auto text = make_unique<Text>(0, 0, "before");
+    Text& nested_text = *text;
+    group->add(move(text));
+    ShapeGroup& nested_group = *group;
+    scene.add(move(group));
+
+    DisplayList list {scene};
+    list.update();
+    list.update();
+    REQUIRE(list.compilation_count() == 1);
+
+    SECTION("text of a nested shape changed")
+    {
+        nested_text.set_text("after");
+        REQUIRE(list.is_stale());
+        REQUIRE(rendered(list) == "Rendering text 'after' at: [0, 0]\n");
+    }
+
+    SECTION("nested shape moved")
+    {
+        nested_text.move_to(7, 8);
+        REQUIRE(rendered(list) == "Rendering text 'before' at: [7, 8]\n");
+    }
+
+    SECTION("nested shape removed")
+    {
+        nested_group.remove(nested_text);
+        REQUIRE(list.items().empty());
+    }
+
+    SECTION("changes after an incremental draw")
+    {
+        RenderBuffer frame;
+        scene.render_incremental(frame);
+
+        nested_text.set_text("first");
+        nested_text.set_text("second"); // shape is already dirty
+        REQUIRE(rendered(list) == "Rendering text 'second' at: [0, 0]\n");
+    }
+
+    REQUIRE(list.compilation_count() == 2);
+}
+
+TEST_CASE("DisplayList - deep hierarchy")
+{
+    constexpr int depth = 1'000;
+
+    auto root = make_unique<ShapeGroup>();
+    ShapeGroup* innermost = root.get();
+    for (int i = 0; i < depth; ++i)
+    {
+        auto group = make_unique<ShapeGroup>();
+        group->add(make_unique<Text>(i, 0, "level"));
+        ShapeGroup* next = group.get();
+        innermost->add(move(group));
+        innermost = next;
+    }
+
+    DisplayList list {*root};
+    REQUIRE(list.items().size() == depth);
+    REQUIRE(list.items().back().position.x == depth - 1);
+
+    REQUIRE(rendered(list) == rendered(*root));
+}
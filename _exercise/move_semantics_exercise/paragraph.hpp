@@ -1,71 +1,184 @@
 #ifndef PARAGRAPH_HPP_
 #define PARAGRAPH_HPP_
 
+#include "render_sink.hpp"
+#include "slab_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace LegacyCode
 {
     // TODO - implement move semantics for Paragraph
     class Paragraph
     {
-        char* buffer_;
+        static constexpr size_t local_capacity = 15;
+
+        char* buffer_; // local_buffer_ for short texts, slab block for long ones, nullptr after move
+        size_t length_;
+
+        union
+        {
+            char local_buffer_[local_capacity + 1];
+            size_t capacity_;
+        };
+
+        bool is_local() const noexcept
+        {
+            return buffer_ == local_buffer_;
+        }
+
+        size_t capacity() const noexcept
+        {
+            if (buffer_ == nullptr)
+                return 0;
+
+            return is_local() ? local_capacity : capacity_;
+        }
+
+        void release() noexcept
+        {
+            if (buffer_ != nullptr && !is_local())
+                SlabAllocator::instance().deallocate(buffer_, capacity_ + 1);
+        }
+
+        void assign(const char* txt, size_t length)
+        {
+            if (buffer_ == nullptr || length > capacity())
+            {
+                if (length > local_capacity)
+                {
+                    const size_t block_size = SlabAllocator::block_size(length + 1);
+                    char* new_buffer = static_cast<char*>(SlabAllocator::instance().allocate(block_size));
+                    std::memcpy(new_buffer, txt, length);
+
+                    release();
+
+                    buffer_ = new_buffer;
+                    capacity_ = block_size - 1;
+                }
+                else
+                {
+                    release();
+
+                    std::memcpy(local_buffer_, txt, length);
+                    buffer_ = local_buffer_;
+                }
+            }
+            else
+            {
+                std::memmove(buffer_, txt, length);
+            }
+
+            buffer_[length] = '\0';
+            length_ = length;
+        }
+
+        void steal(Paragraph& other) noexcept
+        {
+            if (other.is_local())
+            {
+                std::memcpy(local_buffer_, other.local_buffer_, other.length_ + 1);
+                buffer_ = local_buffer_;
+            }
+            else
+            {
+                buffer_ = other.buffer_;
+                capacity_ = other.capacity_;
+            }
+            length_ = other.length_;
+
+            other.buffer_ = nullptr;
+            other.length_ = 0;
+        }
 
     protected:
         void swap(Paragraph& p)
         {
-            std::swap(buffer_, p.buffer_);
+            Paragraph temp(std::move(p));
+            p = std::move(*this);
+            *this = std::move(temp);
         }
 
     public:
         Paragraph()
-            : buffer_(new char[1024])
+            : Paragraph("Default text!")
         {
-            std::strcpy(buffer_, "Default text!");
         }
 
         Paragraph(const Paragraph& p)
-            : buffer_(new char[1024])
+            : buffer_ {nullptr}
+            , length_ {0}
         {
-            std::strcpy(buffer_, p.buffer_);
+            if (p.buffer_ != nullptr)
+                assign(p.buffer_, p.length_);
         }
 
         Paragraph(const char* txt)
-            : buffer_(new char[1024])
+            : Paragraph(txt, std::strlen(txt))
+        {
+        }
+
+        Paragraph(const char* txt, size_t length)
+            : buffer_ {nullptr}
+            , length_ {0}
         {
-            std::strcpy(buffer_, txt);
+            assign(txt, length);
         }
 
         Paragraph& operator=(const Paragraph& p)
         {
-            Paragraph temp(p);
-            swap(temp);
+            if (this != &p)
+            {
+                if (p.buffer_ == nullptr)
+                {
+                    release();
+                    buffer_ = nullptr;
+                    length_ = 0;
+                }
+                else
+                {
+                    assign(p.buffer_, p.length_);
+                }
+            }
 
             return *this;
         }
 
-        Paragraph(Paragraph&& other)
-            : buffer_ {other.buffer_}
+        Paragraph(Paragraph&& other) noexcept
         {
-            other.buffer_ = nullptr;
+            steal(other);
         }
 
-        Paragraph& operator=(Paragraph&& other)
+        Paragraph& operator=(Paragraph&& other) noexcept
         {
             if (this != &other)
             {
-                delete[] buffer_;
-             
-                buffer_ = other.buffer_;
-                other.buffer_ = nullptr;
+                release();
+                steal(other);
             }
             return *this;
         }
 
         void set_paragraph(const char* txt)
         {
-            std::strcpy(buffer_, txt);
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            assign(txt, length);
         }
 
         const char* get_paragraph() const
@@ -73,70 +186,430 @@ namespace LegacyCode
             return buffer_;
         }
 
+        size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text(std::string_view(buffer_ ? buffer_ : "", length_), posx, posy);
+        }
+
         void render_at(int posx, int posy) const
         {
-            std::cout << "Rendering text '" << buffer_ << "' at: [" << posx << ", " << posy << "]" << std::endl;
+            RenderBuffer frame;
+            render_at(frame, posx, posy);
+
+            OstreamSink sink {std::cout};
+            frame.submit(sink);
         }
 
         virtual ~Paragraph()
         {
-            delete[] buffer_;
+            release();
         }
     };
 }
 
+struct Point
+{
+    int x, y;
+};
+
 class Shape
 {
+    Shape* parent_ = nullptr;
+    bool dirty_ = true;
+    std::uint64_t revision_ = 0;
+
+    friend struct ShapeGroup;
+
+protected:
+    // increments revisions of the shape and all enclosing groups
+    void bump_revision() noexcept;
+
+    // marks the shape as changed since the last incremental draw and notifies enclosing groups
+    void mark_dirty();
+
+    void clear_dirty() noexcept
+    {
+        dirty_ = false;
+    }
+
+    // tells the enclosing group that the anchor of the shape has changed
+    void notify_moved(Point old_anchor);
+
+    // makes the shape report its changes to this group
+    void adopt(Shape& child) noexcept
+    {
+        child.parent_ = this;
+    }
+
+    // for groups that render all children when any of them changes: the next change of child is reported again
+    static void mark_rendered(Shape& child) noexcept
+    {
+        child.dirty_ = false;
+    }
+
+    // called by mark_dirty() of a child the first time it changes after being rendered
+    virtual void child_changed(Shape& child)
+    {
+        child.dirty_ = true;
+        mark_dirty();
+    }
+
+    virtual void child_moved(Shape&, Point /*old_anchor*/)
+    {
+    }
+
 public:
+    Shape() = default;
+
+    // a copy is a new shape that does not belong to any group yet
+    Shape(const Shape&) noexcept
+    {
+    }
+
+    Shape& operator=(const Shape&)
+    {
+        mark_dirty();
+        return *this;
+    }
+
     virtual ~Shape() = default;
-    virtual void draw() const = 0;
+
+    bool is_dirty() const noexcept
+    {
+        return dirty_;
+    }
+
+    // changes on every modification of the shape or of any shape below it
+    std::uint64_t revision() const noexcept
+    {
+        return revision_;
+    }
+
+    // position the shape is drawn at - shapes without one (e.g. groups) return nullopt
+    virtual std::optional<Point> anchor() const
+    {
+        return std::nullopt;
+    }
+
+    // appends render commands of the shape to the frame
+    virtual void render(RenderBuffer& frame) const = 0;
+
+    // groups call visitor for every child in the order render() draws them and return true;
+    // other shapes return false (scene compilers flatten only groups)
+    virtual bool visit_children(const std::function<void(const Shape&)>& /*visitor*/) const
+    {
+        return false;
+    }
+
+    // appends render commands of shapes changed since the previous call
+    virtual void render_incremental(RenderBuffer& frame)
+    {
+        if (dirty_)
+        {
+            render(frame);
+            clear_dirty();
+        }
+    }
+
+    // renders the shape as a single frame written to std::cout
+    virtual void draw() const
+    {
+        RenderBuffer frame;
+        render(frame);
+
+        OstreamSink sink {std::cout};
+        frame.submit(sink);
+    }
+
+    // renders changed shapes as a single frame written to std::cout
+    void draw_incremental()
+    {
+        RenderBuffer frame;
+        render_incremental(frame);
+
+        OstreamSink sink {std::cout};
+        frame.submit(sink);
+    }
 };
 
-class Text : public Shape
+// Shape that displays a text - rendered as RenderBuffer::render_text(text_view(), *anchor())
+class TextShape : public Shape
+{
+public:
+    // view of the displayed text - valid until the text is changed
+    virtual std::string_view text_view() const = 0;
+};
+
+template <typename TParagraph>
+class BasicText : public TextShape
 {
     int x_, y_;
-    LegacyCode::Paragraph p_;
+    TParagraph p_;
+
+    void set_anchor(int x, int y)
+    {
+        const Point old_anchor {x_, y_};
+
+        x_ = x;
+        y_ = y;
+        mark_dirty();
+        notify_moved(old_anchor);
+    }
 
 public:
-    Text(int x, int y, const std::string& text)
+    // extra arguments are passed to the paragraph (e.g. a memory resource)
+    template <typename... TParagraphArgs,
+        typename = std::enable_if_t<std::is_constructible_v<TParagraph, const char*, size_t, TParagraphArgs...>>>
+    BasicText(int x, int y, std::string_view text, TParagraphArgs&&... args)
         : x_ {x}
         , y_ {y}
-        , p_ {text.c_str()}
+        , p_ {text.data(), text.size(), std::forward<TParagraphArgs>(args)...}
+    {
+    }
+
+    BasicText(const BasicText&) = default;
+    BasicText(BasicText&&) = default;
+
+    // assignment moves the shape to the anchor of other - the enclosing group is told about it
+    BasicText& operator=(const BasicText& other)
+    {
+        if (this != &other)
+        {
+            p_ = other.p_;
+            set_anchor(other.x_, other.y_);
+        }
+        return *this;
+    }
+
+    BasicText& operator=(BasicText&& other)
+    {
+        if (this != &other)
+        {
+            p_ = std::move(other.p_);
+            set_anchor(other.x_, other.y_);
+        }
+        return *this;
+    }
+
+    void render(RenderBuffer& frame) const override
+    {
+        p_.render_at(frame, x_, y_);
+    }
+
+    int x() const noexcept
     {
+        return x_;
     }
 
-    void draw() const override
+    int y() const noexcept
     {
-        p_.render_at(x_, y_);
+        return y_;
+    }
+
+    std::optional<Point> anchor() const override
+    {
+        return Point {x_, y_};
+    }
+
+    void move_to(int x, int y)
+    {
+        set_anchor(x, y);
     }
 
     std::string text() const
     {
         const char* txt = p_.get_paragraph();
-        return (txt == nullptr) ? "" : txt;
+        return (txt == nullptr) ? std::string() : std::string(txt, p_.length());
+    }
+
+    std::string_view text_view() const override
+    {
+        const char* txt = p_.get_paragraph();
+        return (txt == nullptr) ? std::string_view() : std::string_view(txt, p_.length());
     }
 
     void set_text(const std::string& text)
     {
-        p_.set_paragraph(text.c_str());
+        p_.set_paragraph(text.c_str(), text.size());
+        mark_dirty();
+    }
+
+    const TParagraph& paragraph() const noexcept
+    {
+        return p_;
     }
 };
 
+using Text = BasicText<LegacyCode::Paragraph>;
+
+// Children report their changes to the group, so render_incremental() visits only the changed subtrees
+// (in order of changes) - children are added and removed only with add(), remove() and clear()
 struct ShapeGroup : public Shape
 {
-    std::vector<std::unique_ptr<Shape>> shapes;
-
     ShapeGroup() = default;
 
-    void draw() const override
+    ShapeGroup(ShapeGroup&& other) noexcept
+        : shapes_ {std::move(other.shapes_)}
+        , dirty_children_ {std::move(other.dirty_children_)}
+    {
+        adopt_children();
+        other.bump_revision();
+    }
+
+    ShapeGroup& operator=(ShapeGroup&& other) noexcept
+    {
+        if (this != &other)
+        {
+            orphan_children();
+
+            shapes_ = std::move(other.shapes_);
+            dirty_children_ = std::move(other.dirty_children_);
+            adopt_children();
+            mark_dirty();
+            other.bump_revision();
+        }
+        return *this;
+    }
+
+    ~ShapeGroup()
+    {
+        orphan_children();
+    }
+
+    // children in drawing order
+    const std::vector<std::unique_ptr<Shape>>& shapes() const noexcept
+    {
+        return shapes_;
+    }
+
+    void render(RenderBuffer& frame) const override
+    {
+        for (const auto& s : shapes_)
+            s->render(frame);
+    }
+
+    bool visit_children(const std::function<void(const Shape&)>& visitor) const override
     {
-        for (const auto& s : shapes)
-            s->draw();
+        for (const auto& s : shapes_)
+            visitor(*s);
+
+        return true;
+    }
+
+    void render_incremental(RenderBuffer& frame) override
+    {
+        for (Shape* child : dirty_children_)
+            child->render_incremental(frame);
+
+        dirty_children_.clear();
+        clear_dirty();
     }
 
     void add(std::unique_ptr<Shape> shape){
-        shapes.push_back(std::move(shape));
+        shape->parent_ = this;
+        shapes_.push_back(std::move(shape));
+        child_added(*shapes_.back());
+        child_changed(*shapes_.back());
+    }
+
+    // returns nullptr when the shape is not a child of the group
+    std::unique_ptr<Shape> remove(const Shape& shape)
+    {
+        auto pos = std::find_if(shapes_.begin(), shapes_.end(), [&shape](const auto& s) { return s.get() == &shape; });
+        if (pos == shapes_.end())
+            return nullptr;
+
+        std::unique_ptr<Shape> removed = std::move(*pos);
+        shapes_.erase(pos);
+        dirty_children_.erase(std::remove(dirty_children_.begin(), dirty_children_.end(), removed.get()), dirty_children_.end());
+
+        child_removed(*removed);
+        removed->parent_ = nullptr;
+        bump_revision();
+
+        return removed;
+    }
+
+    // destroys all children
+    void clear()
+    {
+        for (auto& s : shapes_)
+            child_removed(*s);
+
+        orphan_children();
+        dirty_children_.clear();
+        shapes_.clear();
+        bump_revision();
+    }
+
+protected:
+    // hooks for groups that index their children
+    virtual void child_added(Shape&)
+    {
+    }
+
+    virtual void child_removed(Shape&)
+    {
+    }
+
+private:
+    std::vector<std::unique_ptr<Shape>> shapes_;
+    std::vector<Shape*> dirty_children_; // point into shapes_ - kept in sync by add(), remove() and clear()
+
+    void child_changed(Shape& child) override
+    {
+        child.dirty_ = true;
+        dirty_children_.push_back(&child);
+        mark_dirty();
+    }
+
+    void adopt_children() noexcept
+    {
+        for (auto& s : shapes_)
+        {
+            if (s)
+                s->parent_ = this;
+        }
+    }
+
+    void orphan_children() noexcept
+    {
+        for (auto& s : shapes_)
+        {
+            if (s)
+                s->parent_ = nullptr;
+        }
     }
 };
 
+inline void Shape::notify_moved(Point old_anchor)
+{
+    if (parent_ != nullptr)
+        parent_->child_moved(*this, old_anchor);
+}
+
+inline void Shape::bump_revision() noexcept
+{
+    for (Shape* s = this; s != nullptr; s = s->parent_)
+        ++s->revision_;
+}
+
+inline void Shape::mark_dirty()
+{
+    bump_revision(); // unlike dirty flags, revisions must reach the root on every change
+
+    if (dirty_)
+        return;
+
+    if (parent_ != nullptr)
+        parent_->child_changed(*this);
+    else
+        dirty_ = true;
+}
+
 #endif /*PARAGRAPH_HPP_*/
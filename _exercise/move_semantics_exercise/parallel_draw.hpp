@@ -0,0 +1,96 @@
+#ifndef PARALLEL_DRAW_HPP_
+#define PARALLEL_DRAW_HPP_
+
+#include "paragraph.hpp"
+#include "render_sink.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// appends leaf shapes of the scene in drawing order - groups of every kind (see Shape::visit_children) are expanded
+inline void collect_leaves(const Shape& shape, std::vector<const Shape*>& leaves)
+{
+    if (!shape.visit_children([&leaves](const Shape& child) { collect_leaves(child, leaves); }))
+        leaves.push_back(&shape);
+}
+
+// Renders the scene on several threads
+// - leaves are split into contiguous ranges, one per thread
+// - every thread renders into its own buffer
+// - buffers are appended to the frame in scene order, so the output is identical to Shape::render()
+inline void render_parallel(const Shape& scene, RenderBuffer& frame, unsigned thread_count = std::thread::hardware_concurrency())
+{
+    constexpr size_t min_shapes_per_thread = 1024;
+
+    std::vector<const Shape*> leaves;
+    collect_leaves(scene, leaves);
+
+    const size_t max_threads = std::max<size_t>(1, leaves.size() / min_shapes_per_thread);
+    thread_count = static_cast<unsigned>(std::clamp<size_t>(thread_count, 1, max_threads));
+
+    if (thread_count == 1)
+    {
+        for (const Shape* s : leaves)
+            s->render(frame);
+        return;
+    }
+
+    std::vector<RenderBuffer> parts(thread_count);
+    std::vector<std::exception_ptr> errors(thread_count);
+
+    auto render_range = [&](unsigned part) {
+        const size_t first = leaves.size() * part / thread_count;
+        const size_t last = leaves.size() * (part + 1) / thread_count;
+
+        try
+        {
+            for (size_t i = first; i < last; ++i)
+                leaves[i]->render(parts[part]);
+        }
+        catch (...)
+        {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    try
+    {
+        for (unsigned part = 1; part < thread_count; ++part)
+            workers.emplace_back(render_range, part);
+    }
+    catch (...)
+    {
+        // destroying a joinable std::thread terminates the program
+        for (auto& worker : workers)
+            worker.join();
+        throw;
+    }
+
+    render_range(0);
+
+    for (auto& worker : workers)
+        worker.join();
+
+    for (const auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    for (auto& part : parts)
+        frame.append(std::move(part));
+}
+
+inline void draw_parallel(const Shape& scene, RenderSink& sink, unsigned thread_count = std::thread::hardware_concurrency())
+{
+    RenderBuffer frame;
+    render_parallel(scene, frame, thread_count);
+    frame.submit(sink);
+}
+
+#endif /*PARALLEL_DRAW_HPP_*/
@@ -0,0 +1,92 @@
+#include "arena_shape_group.hpp"
+#include "catch.hpp"
+#include "cow_paragraph.hpp"
+#include "parallel_draw.hpp"
+#include "static_shape_group.hpp"
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    ShapeGroup create_scene(int groups, int texts_per_group)
+    {
+        ShapeGroup scene;
+        for (int g = 0; g < groups; ++g)
+        {
+            auto group = make_unique<ShapeGroup>();
+            for (int i = 0; i < texts_per_group; ++i)
+                group->add(make_unique<Text>(g, i, "text-" + to_string(i)));
+
+            if (g % 3 == 0)
+            {
+                auto nested = make_unique<ShapeGroup>();
+                nested->add(make_unique<CowText>(-g, 0, "nested"));
+                group->add(move(nested));
+            }
+
+            scene.add(move(group));
+            scene.add(make_unique<Text>(g, -1, "top level"));
+        }
+
+        return scene;
+    }
+}
+
+TEST_CASE("render_parallel - output is the same as serial render")
+{
+    ShapeGroup scene = create_scene(20, 500);
+
+    RenderBuffer serial;
+    scene.render(serial);
+
+    for (unsigned threads : {1u, 2u, 3u, 7u, 16u})
+    {
+        StringSink sink;
+        draw_parallel(scene, sink, threads);
+
+        REQUIRE(sink.str() == serial.str());
+    }
+}
+
+TEST_CASE("collect_leaves - expands nested groups in order")
+{
+    ShapeGroup scene = create_scene(4, 2);
+
+    vector<const Shape*> leaves;
+    collect_leaves(scene, leaves);
+
+    REQUIRE(leaves.size() == 4 * 3 + 2);
+    REQUIRE(dynamic_cast<const Text&>(*leaves[0]).text() == "text-0"s);
+    REQUIRE(dynamic_cast<const CowText&>(*leaves[2]).text() == "nested"s);
+}
+
+TEST_CASE("collect_leaves - splits static and arena groups")
+{
+    ShapeGroup scene;
+
+    auto static_group = make_unique<StaticShapeGroup<Text, CowText>>();
+    static_group->add(Text {0, 0, "static"});
+    static_group->add(CowText {0, 1, "static cow"});
+    scene.add(move(static_group));
+
+    auto arena_group = make_unique<ArenaShapeGroup>();
+    for (int i = 0; i < 3000; ++i)
+        arena_group->add_text(1, i, "arena-" + to_string(i));
+    scene.add(move(arena_group));
+
+    vector<const Shape*> leaves;
+    collect_leaves(scene, leaves);
+
+    REQUIRE(leaves.size() == 2 + 3000);
+    REQUIRE(dynamic_cast<const Text&>(*leaves[0]).text() == "static"s);
+    REQUIRE(dynamic_cast<const ArenaText&>(*leaves[2]).text() == "arena-0"s);
+
+    RenderBuffer serial;
+    scene.render(serial);
+
+    StringSink sink;
+    draw_parallel(scene, sink, 3);
+    REQUIRE(sink.str() == serial.str());
+}
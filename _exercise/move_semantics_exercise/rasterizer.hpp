@@ -0,0 +1,421 @@
+#ifndef RASTERIZER_HPP_
+#define RASTERIZER_HPP_
+
+#include "display_list.hpp"
+#include "paragraph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RASTERIZER_HAS_SSE2
+#endif
+
+// pixels are stored as 0xAABBGGRR - R, G, B, A bytes in memory on little-endian machines
+constexpr std::uint32_t rgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255) noexcept
+{
+    return std::uint32_t(r) | (std::uint32_t(g) << 8) | (std::uint32_t(b) << 16) | (std::uint32_t(a) << 24);
+}
+
+// In-memory RGBA image, rows stored top to bottom
+class Framebuffer
+{
+    int width_, height_;
+    std::vector<std::uint32_t> pixels_;
+
+public:
+    Framebuffer(int width, int height, std::uint32_t color = rgba(0, 0, 0))
+        : width_ {width}
+        , height_ {height}
+    {
+        if (width < 0 || height < 0)
+            throw std::invalid_argument("Framebuffer: negative size");
+
+        pixels_.assign(size_t(width) * size_t(height), color);
+    }
+
+    int width() const noexcept
+    {
+        return width_;
+    }
+
+    int height() const noexcept
+    {
+        return height_;
+    }
+
+    std::uint32_t pixel(int x, int y) const noexcept
+    {
+        return pixels_[size_t(y) * size_t(width_) + size_t(x)];
+    }
+
+    std::uint32_t* row(int y) noexcept
+    {
+        return pixels_.data() + size_t(y) * size_t(width_);
+    }
+
+    const std::uint32_t* data() const noexcept
+    {
+        return pixels_.data();
+    }
+
+    size_t size_bytes() const noexcept
+    {
+        return pixels_.size() * sizeof(std::uint32_t);
+    }
+
+    void clear(std::uint32_t color)
+    {
+        std::fill(pixels_.begin(), pixels_.end(), color);
+    }
+
+    friend bool operator==(const Framebuffer& lhs, const Framebuffer& rhs) noexcept
+    {
+        return lhs.width_ == rhs.width_ && lhs.height_ == rhs.height_ && lhs.pixels_ == rhs.pixels_;
+    }
+
+    friend bool operator!=(const Framebuffer& lhs, const Framebuffer& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
+
+// 8x8 font for printable ASCII (0x20 - 0x7E); bit 0 of a row is its leftmost pixel
+struct BitmapFont
+{
+    static constexpr int glyph_size = 8;
+    static constexpr char first_char = 0x20;
+    static constexpr char last_char = 0x7E;
+    static constexpr char fallback_char = '?';
+
+    static constexpr std::uint8_t glyphs[last_char - first_char + 1][glyph_size] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+        {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // '!'
+        {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+        {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // '#'
+        {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // '$'
+        {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // '%'
+        {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // '&'
+        {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '''
+        {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // '('
+        {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // ')'
+        {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // '*'
+        {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // '+'
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ','
+        {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // '-'
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // '.'
+        {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // '/'
+        {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // '0'
+        {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // '1'
+        {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // '2'
+        {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // '3'
+        {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // '4'
+        {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // '5'
+        {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // '6'
+        {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // '7'
+        {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // '8'
+        {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // '9'
+        {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+        {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ';'
+        {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // '<'
+        {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // '='
+        {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // '>'
+        {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // '?'
+        {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // '@'
+        {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // 'A'
+        {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // 'B'
+        {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // 'C'
+        {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // 'D'
+        {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // 'E'
+        {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // 'F'
+        {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // 'G'
+        {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // 'H'
+        {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'I'
+        {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // 'J'
+        {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // 'K'
+        {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // 'L'
+        {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // 'M'
+        {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // 'N'
+        {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // 'O'
+        {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // 'P'
+        {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // 'Q'
+        {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // 'R'
+        {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // 'S'
+        {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'T'
+        {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // 'U'
+        {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // 'V'
+        {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // 'W'
+        {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // 'X'
+        {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // 'Y'
+        {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // 'Z'
+        {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // '['
+        {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // '\'
+        {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ']'
+        {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // '^'
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // '_'
+        {0x0C, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, // '`'
+        {0x00, 0x00, 0x1E, 0x30, 0x3E, 0x33, 0x6E, 0x00}, // 'a'
+        {0x07, 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3B, 0x00}, // 'b'
+        {0x00, 0x00, 0x1E, 0x33, 0x03, 0x33, 0x1E, 0x00}, // 'c'
+        {0x38, 0x30, 0x30, 0x3E, 0x33, 0x33, 0x6E, 0x00}, // 'd'
+        {0x00, 0x00, 0x1E, 0x33, 0x3F, 0x03, 0x1E, 0x00}, // 'e'
+        {0x1C, 0x36, 0x06, 0x0F, 0x06, 0x06, 0x0F, 0x00}, // 'f'
+        {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // 'g'
+        {0x07, 0x06, 0x36, 0x6E, 0x66, 0x66, 0x67, 0x00}, // 'h'
+        {0x0C, 0x00, 0x0E, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'i'
+        {0x30, 0x00, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E}, // 'j'
+        {0x07, 0x06, 0x66, 0x36, 0x1E, 0x36, 0x67, 0x00}, // 'k'
+        {0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'l'
+        {0x00, 0x00, 0x33, 0x7F, 0x7F, 0x6B, 0x63, 0x00}, // 'm'
+        {0x00, 0x00, 0x1F, 0x33, 0x33, 0x33, 0x33, 0x00}, // 'n'
+        {0x00, 0x00, 0x1E, 0x33, 0x33, 0x33, 0x1E, 0x00}, // 'o'
+        {0x00, 0x00, 0x3B, 0x66, 0x66, 0x3E, 0x06, 0x0F}, // 'p'
+        {0x00, 0x00, 0x6E, 0x33, 0x33, 0x3E, 0x30, 0x78}, // 'q'
+        {0x00, 0x00, 0x3B, 0x6E, 0x66, 0x06, 0x0F, 0x00}, // 'r'
+        {0x00, 0x00, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x00}, // 's'
+        {0x08, 0x0C, 0x3E, 0x0C, 0x0C, 0x2C, 0x18, 0x00}, // 't'
+        {0x00, 0x00, 0x33, 0x33, 0x33, 0x33, 0x6E, 0x00}, // 'u'
+        {0x00, 0x00, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // 'v'
+        {0x00, 0x00, 0x63, 0x6B, 0x7F, 0x7F, 0x36, 0x00}, // 'w'
+        {0x00, 0x00, 0x63, 0x36, 0x1C, 0x36, 0x63, 0x00}, // 'x'
+        {0x00, 0x00, 0x33, 0x33, 0x33, 0x3E, 0x30, 0x1F}, // 'y'
+        {0x00, 0x00, 0x3F, 0x19, 0x0C, 0x26, 0x3F, 0x00}, // 'z'
+        {0x38, 0x0C, 0x0C, 0x07, 0x0C, 0x0C, 0x38, 0x00}, // '{'
+        {0x18, 0x18, 0x18, 0x00, 0x18, 0x18, 0x18, 0x00}, // '|'
+        {0x07, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0x07, 0x00}, // '}'
+        {0x6E, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '~'
+    };
+
+    // characters outside of the font are drawn as fallback_char
+    static constexpr int index_of(char c) noexcept
+    {
+        return (c >= first_char && c <= last_char) ? c - first_char : fallback_char - first_char;
+    }
+};
+
+// Glyphs of BitmapFont expanded to one 32-bit mask per pixel (all ones where the glyph is set),
+// so a glyph row is blitted with a few wide and/or operations instead of testing single bits
+class GlyphAtlas
+{
+public:
+    static constexpr int glyph_size = BitmapFont::glyph_size;
+    static constexpr int glyph_count = BitmapFont::last_char - BitmapFont::first_char + 1;
+
+private:
+    struct alignas(16) Glyph
+    {
+        std::uint32_t mask[glyph_size * glyph_size];
+    };
+
+    std::array<Glyph, glyph_count> glyphs_;
+
+    GlyphAtlas() noexcept
+    {
+        for (int g = 0; g < glyph_count; ++g)
+            for (int y = 0; y < glyph_size; ++y)
+                for (int x = 0; x < glyph_size; ++x)
+                    glyphs_[g].mask[y * glyph_size + x] = ((BitmapFont::glyphs[g][y] >> x) & 1u) ? 0xFFFFFFFFu : 0u;
+    }
+
+public:
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // built once - shared by all rasterizers
+    static const GlyphAtlas& instance()
+    {
+        static const GlyphAtlas atlas;
+        return atlas;
+    }
+
+    const std::uint32_t* glyph(char c) const noexcept
+    {
+        return glyphs_[BitmapFont::index_of(c)].mask;
+    }
+
+    // draws one row of a glyph - dst[i] = color where the glyph is set, unchanged elsewhere
+    static void blit_row(std::uint32_t* dst, const std::uint32_t* mask, std::uint32_t color) noexcept
+    {
+#ifdef RASTERIZER_HAS_SSE2
+        const __m128i fill = _mm_set1_epi32(static_cast<int>(color));
+        for (int i = 0; i < glyph_size; i += 4)
+        {
+            const __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(mask + i));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_andnot_si128(m, d), _mm_and_si128(m, fill)));
+        }
+#else
+        for (int i = 0; i < glyph_size; ++i)
+            dst[i] = (dst[i] & ~mask[i]) | (color & mask[i]);
+#endif
+    }
+
+    // the same for a part of a row clipped by the framebuffer edges
+    static void blit_span(std::uint32_t* dst, const std::uint32_t* mask, std::uint32_t color, int count) noexcept
+    {
+        for (int i = 0; i < count; ++i)
+            dst[i] = (dst[i] & ~mask[i]) | (color & mask[i]);
+    }
+};
+
+// Draws text shapes of a scene into a Framebuffer with BitmapFont
+// - a text is drawn with its top-left corner at the anchor of the shape, 8 pixels per character,
+//   '\n' starts a new line; groups are flattened, other shapes that are not TextShapes are skipped
+// - the framebuffer is split into horizontal bands rendered in parallel; every band draws
+//   its texts in scene order, so the image is byte-identical for any number of threads
+class Rasterizer
+{
+    static constexpr int glyph_size = GlyphAtlas::glyph_size;
+
+    struct GlyphRun
+    {
+        int x, y;
+        std::string_view text; // single line
+    };
+
+    std::uint32_t foreground_;
+    std::uint32_t background_;
+    int band_height_;
+
+    void draw_run(Framebuffer& frame, const GlyphRun& run, int band_top, int band_bottom) const
+    {
+        const GlyphAtlas& atlas = GlyphAtlas::instance();
+
+        const int first_row = std::max(band_top, run.y) - run.y;
+        const int last_row = std::min(band_bottom, run.y + glyph_size) - run.y;
+
+        // characters left of the framebuffer are skipped without drawing
+        const size_t first_visible = (run.x >= 0) ? 0 : size_t((-std::int64_t(run.x)) / glyph_size);
+
+        for (size_t i = first_visible; i < run.text.size(); ++i)
+        {
+            const std::int64_t glyph_x = run.x + std::int64_t(i) * glyph_size;
+            if (glyph_x >= frame.width())
+                break;
+
+            const std::uint32_t* glyph = atlas.glyph(run.text[i]);
+            const int x = static_cast<int>(glyph_x);
+
+            if (x >= 0 && x + glyph_size <= frame.width())
+            {
+                for (int r = first_row; r < last_row; ++r)
+                    GlyphAtlas::blit_row(frame.row(run.y + r) + x, glyph + r * glyph_size, foreground_);
+            }
+            else
+            {
+                const int first_column = std::max(0, -x);
+                const int last_column = std::min(glyph_size, frame.width() - x);
+
+                for (int r = first_row; r < last_row; ++r)
+                {
+                    GlyphAtlas::blit_span(frame.row(run.y + r) + (x + first_column), glyph + r * glyph_size + first_column,
+                        foreground_, last_column - first_column);
+                }
+            }
+        }
+    }
+
+public:
+    explicit Rasterizer(std::uint32_t foreground = rgba(255, 255, 255), std::uint32_t background = rgba(0, 0, 0), int band_height = 64)
+        : foreground_ {foreground}
+        , background_ {background}
+        , band_height_ {band_height}
+    {
+        if (band_height <= 0)
+            throw std::invalid_argument("Rasterizer: band height must be positive");
+    }
+
+    // clears the frame and draws the scene; returns the number of glyphs laid out
+    size_t rasterize(DisplayList& scene, Framebuffer& frame, unsigned thread_count = std::thread::hardware_concurrency()) const
+    {
+        frame.clear(background_);
+
+        const int band_count = (frame.height() + band_height_ - 1) / band_height_;
+        std::vector<std::vector<GlyphRun>> bands(band_count);
+        size_t glyph_count = 0;
+
+        // splits texts into lines and assigns every line to the bands it overlaps - in scene order
+        for (const DisplayItem& item : scene.items())
+        {
+            if (item.opaque != nullptr)
+                continue;
+
+            std::int64_t y = item.position.y;
+            std::string_view text = item.text;
+
+            while (true)
+            {
+                const size_t end_of_line = text.find('\n');
+                const std::string_view line = text.substr(0, end_of_line);
+                glyph_count += line.size();
+
+                const std::int64_t right = item.position.x + std::int64_t(line.size()) * glyph_size;
+                if (!line.empty() && y + glyph_size > 0 && y < frame.height() && right > 0 && item.position.x < frame.width())
+                {
+                    const int line_y = static_cast<int>(y);
+                    const int first_band = std::max(0, line_y) / band_height_;
+                    const int last_band = std::min(frame.height() - 1, line_y + glyph_size - 1) / band_height_;
+
+                    for (int b = first_band; b <= last_band; ++b)
+                        bands[b].push_back(GlyphRun {item.position.x, line_y, line});
+                }
+
+                if (end_of_line == std::string_view::npos)
+                    break;
+
+                text.remove_prefix(end_of_line + 1);
+                y += glyph_size;
+            }
+        }
+
+        std::atomic<int> next_band {0};
+        auto render_bands = [&] {
+            for (int b = next_band++; b < band_count; b = next_band++)
+            {
+                const int band_top = b * band_height_;
+                const int band_bottom = std::min(frame.height(), band_top + band_height_);
+
+                for (const GlyphRun& run : bands[b])
+                    draw_run(frame, run, band_top, band_bottom);
+            }
+        };
+
+        thread_count = static_cast<unsigned>(std::clamp<int>(static_cast<int>(thread_count), 1, std::max(1, band_count)));
+
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count - 1);
+        try
+        {
+            for (unsigned i = 1; i < thread_count; ++i)
+                workers.emplace_back(render_bands);
+        }
+        catch (...)
+        {
+            for (auto& worker : workers)
+                worker.join();
+            throw;
+        }
+
+        render_bands();
+
+        for (auto& worker : workers)
+            worker.join();
+
+        return glyph_count;
+    }
+
+    size_t rasterize(const Shape& scene, Framebuffer& frame, unsigned thread_count = std::thread::hardware_concurrency()) const
+    {
+        DisplayList list {scene};
+        return rasterize(list, frame, thread_count);
+    }
+};
+
+#endif /*RASTERIZER_HPP_*/
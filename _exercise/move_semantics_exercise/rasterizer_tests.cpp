@@ -0,0 +1,132 @@
+#include "arena_shape_group.hpp"
+#include "catch.hpp"
+#include "cow_paragraph.hpp"
+#include "rasterizer.hpp"
+#include "static_shape_group.hpp"
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    constexpr uint32_t white = rgba(255, 255, 255);
+    constexpr uint32_t black = rgba(0, 0, 0);
+
+    bool glyph_pixel(char c, int x, int y)
+    {
+        return (BitmapFont::glyphs[BitmapFont::index_of(c)][y] >> x) & 1u;
+    }
+
+    bool matches_glyph(const Framebuffer& frame, char c, int left, int top)
+    {
+        for (int y = 0; y < 8; ++y)
+            for (int x = 0; x < 8; ++x)
+            {
+                if (frame.pixel(left + x, top + y) != (glyph_pixel(c, x, y) ? white : black))
+                    return false;
+            }
+
+        return true;
+    }
+}
+
+TEST_CASE("Rasterizer - draws glyphs of the bitmap font")
+{
+    ShapeGroup scene;
+    scene.add(make_unique<Text>(4, 2, "Hi!"));
+    scene.add(make_unique<Text>(0, 20, "a\nb"));
+
+    Framebuffer frame {40, 40};
+    const size_t glyphs = Rasterizer {}.rasterize(scene, frame, 1);
+
+    REQUIRE(glyphs == 5);
+    REQUIRE(matches_glyph(frame, 'H', 4, 2));
+    REQUIRE(matches_glyph(frame, 'i', 12, 2));
+    REQUIRE(matches_glyph(frame, '!', 20, 2));
+
+    SECTION("new line starts below the previous one")
+    {
+        REQUIRE(matches_glyph(frame, 'a', 0, 20));
+        REQUIRE(matches_glyph(frame, 'b', 0, 28));
+    }
+
+    SECTION("characters outside of the font are drawn as '?'")
+    {
+        scene.add(make_unique<Text>(30, 0, "\xE9"));
+        Rasterizer {}.rasterize(scene, frame, 1);
+
+        REQUIRE(matches_glyph(frame, '?', 30, 0));
+    }
+}
+
+TEST_CASE("Rasterizer - texts are clipped at the framebuffer edges")
+{
+    ShapeGroup scene;
+    scene.add(make_unique<Text>(-4, -3, "AB"));
+    scene.add(make_unique<Text>(12, 13, "CD"));
+    scene.add(make_unique<Text>(-1'000'000, 0, "far away"));
+    scene.add(make_unique<Text>(0, 2'000'000'000, "below"));
+
+    Framebuffer frame {16, 16};
+    Rasterizer {rgba(255, 0, 0)}.rasterize(scene, frame, 1);
+
+    REQUIRE(frame.pixel(0, 0) == ((glyph_pixel('A', 4, 3)) ? rgba(255, 0, 0) : black));
+    REQUIRE(frame.pixel(15, 15) == ((glyph_pixel('C', 3, 2)) ? rgba(255, 0, 0) : black));
+}
+
+TEST_CASE("Rasterizer - later shapes are drawn over earlier ones")
+{
+    ShapeGroup scene;
+    scene.add(make_unique<Text>(0, 0, "_"));
+    scene.add(make_unique<Text>(0, 0, " "));
+
+    Framebuffer frame {8, 8};
+    Rasterizer {}.rasterize(scene, frame, 1);
+
+    REQUIRE(frame.pixel(0, 7) == white); // space is transparent
+}
+
+TEST_CASE("Rasterizer - texts in static and arena groups are drawn")
+{
+    auto static_group = make_unique<StaticShapeGroup<Text, CowText>>();
+    static_group->emplace<Text>(0, 0, "S");
+    static_group->emplace<CowText>(8, 0, "C");
+
+    auto arena_group = make_unique<ArenaShapeGroup>();
+    arena_group->add_text(16, 0, "A");
+
+    ShapeGroup scene;
+    scene.add(move(static_group));
+    scene.add(move(arena_group));
+
+    Framebuffer frame {24, 8};
+    REQUIRE(Rasterizer {}.rasterize(scene, frame, 1) == 3);
+
+    REQUIRE(matches_glyph(frame, 'S', 0, 0));
+    REQUIRE(matches_glyph(frame, 'C', 8, 0));
+    REQUIRE(matches_glyph(frame, 'A', 16, 0));
+}
+
+TEST_CASE("Rasterizer - image is the same for any number of threads")
+{
+    ShapeGroup scene;
+    for (int i = 0; i < 2'000; ++i)
+    {
+        auto group = make_unique<ShapeGroup>();
+        group->add(make_unique<Text>((i * 37) % 500 - 20, (i * 53) % 400 - 4, "text " + to_string(i) + "\nline"));
+        scene.add(move(group));
+    }
+
+    Framebuffer expected {480, 380};
+    Rasterizer rasterizer {rgba(10, 200, 30), rgba(5, 5, 5), 16};
+    rasterizer.rasterize(scene, expected, 1);
+
+    for (unsigned threads : {2u, 3u, 8u, 64u})
+    {
+        Framebuffer frame {480, 380};
+        rasterizer.rasterize(scene, frame, threads);
+
+        REQUIRE(frame == expected);
+    }
+}
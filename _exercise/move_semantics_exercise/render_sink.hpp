@@ -0,0 +1,241 @@
+#ifndef RENDER_SINK_HPP_
+#define RENDER_SINK_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#define RENDER_SINK_HAS_WRITEV
+#endif
+
+// Destination of rendered frames - receives all chunks of one frame in a single call
+class RenderSink
+{
+public:
+    virtual ~RenderSink() = default;
+    virtual void write(const std::string_view* chunks, size_t count) = 0;
+};
+
+// Render commands of one frame, kept as a list of text chunks
+// - chunks double in size from 256 B up to 64 KiB, so small frames (e.g. a single draw()) stay small
+class RenderBuffer
+{
+    static constexpr size_t min_chunk_capacity = 256;
+    static constexpr size_t max_chunk_capacity = 64 * 1024;
+
+    std::vector<std::string> chunks_;
+    size_t size_ = 0;
+
+    std::string& chunk_with_room(size_t count)
+    {
+        if (chunks_.empty() || chunks_.back().size() + count > chunks_.back().capacity())
+        {
+            const size_t chunk_capacity =
+                chunks_.empty() ? min_chunk_capacity : std::min(2 * chunks_.back().capacity(), max_chunk_capacity);
+
+            chunks_.emplace_back();
+            chunks_.back().reserve(std::max(chunk_capacity, count));
+        }
+
+        return chunks_.back();
+    }
+
+public:
+    void append(std::string_view text)
+    {
+        chunk_with_room(text.size()).append(text);
+        size_ += text.size();
+    }
+
+    void append(int value)
+    {
+        char digits[16];
+        const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        append(std::string_view(digits, result.ptr - digits));
+    }
+
+    // appends all commands of other - chunks are moved, not copied
+    void append(RenderBuffer&& other)
+    {
+        size_ += other.size_;
+        for (auto& chunk : other.chunks_)
+            chunks_.push_back(std::move(chunk));
+
+        other.clear();
+    }
+
+    // command rendering a text at given position
+    void render_text(std::string_view text, int posx, int posy)
+    {
+        render_text_parts([text](RenderBuffer& frame) { frame.append(text); }, posx, posy);
+    }
+
+    // command rendering a text that is not contiguous in memory - append_text(RenderBuffer&) appends its parts
+    template <typename TAppendText>
+    void render_text_parts(TAppendText append_text, int posx, int posy)
+    {
+        append("Rendering text '");
+        append_text(*this);
+        append("' at: [");
+        append(posx);
+        append(", ");
+        append(posy);
+        append("]\n");
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // bytes reserved for the chunks of the frame
+    size_t capacity() const noexcept
+    {
+        size_t result = 0;
+        for (const auto& chunk : chunks_)
+            result += chunk.capacity();
+
+        return result;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    void clear() noexcept
+    {
+        chunks_.clear();
+        size_ = 0;
+    }
+
+    std::string str() const
+    {
+        std::string result;
+        result.reserve(size_);
+        for (const auto& chunk : chunks_)
+            result += chunk;
+
+        return result;
+    }
+
+    // writes the whole frame to the sink with one call and starts a new frame
+    void submit(RenderSink& sink)
+    {
+        std::vector<std::string_view> views(chunks_.begin(), chunks_.end());
+        sink.write(views.data(), views.size());
+        clear();
+    }
+};
+
+// In-memory sink - collects everything that was submitted
+class StringSink : public RenderSink
+{
+    std::string output_;
+
+public:
+    void write(const std::string_view* chunks, size_t count) override
+    {
+        for (size_t i = 0; i < count; ++i)
+            output_.append(chunks[i]);
+    }
+
+    const std::string& str() const noexcept
+    {
+        return output_;
+    }
+
+    void clear() noexcept
+    {
+        output_.clear();
+    }
+};
+
+// Writes frames to a stream and flushes it once per frame
+class OstreamSink : public RenderSink
+{
+    std::ostream& out_;
+
+public:
+    explicit OstreamSink(std::ostream& out)
+        : out_ {out}
+    {
+    }
+
+    void write(const std::string_view* chunks, size_t count) override
+    {
+        for (size_t i = 0; i < count; ++i)
+            out_.write(chunks[i].data(), chunks[i].size());
+
+        out_.flush();
+    }
+};
+
+#ifdef RENDER_SINK_HAS_WRITEV
+// Writes every frame to a file descriptor with vectored writes
+class FdSink : public RenderSink
+{
+    int fd_;
+
+public:
+    explicit FdSink(int fd = STDOUT_FILENO)
+        : fd_ {fd}
+    {
+    }
+
+    void write(const std::string_view* chunks, size_t count) override
+    {
+        std::vector<iovec> iov;
+        iov.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!chunks[i].empty())
+                iov.push_back(iovec {const_cast<char*>(chunks[i].data()), chunks[i].size()});
+        }
+
+        size_t first = 0;
+        while (first < iov.size())
+        {
+            const int batch = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+            ssize_t written = ::writev(fd_, &iov[first], batch);
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error(errno, std::generic_category(), "FdSink: writev failed");
+            }
+
+            // all pending buffers are non-empty - no progress would loop forever
+            if (written == 0)
+                throw std::system_error(std::make_error_code(std::errc::io_error), "FdSink: writev wrote nothing");
+
+            // skip fully written buffers and adjust a partially written one
+            while (first < iov.size() && static_cast<size_t>(written) >= iov[first].iov_len)
+            {
+                written -= iov[first].iov_len;
+                ++first;
+            }
+
+            if (written > 0)
+            {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + written;
+                iov[first].iov_len -= written;
+            }
+        }
+    }
+};
+#endif
+
+#endif /*RENDER_SINK_HPP_*/
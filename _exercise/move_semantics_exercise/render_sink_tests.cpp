@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include "paragraph.hpp"
+#include "render_sink.hpp"
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    ShapeGroup create_scene()
+    {
+        ShapeGroup scene;
+        scene.add(make_unique<Text>(10, 20, "text"));
+        scene.add(make_unique<Text>(-5, 0, "other text"));
+
+        auto nested = make_unique<ShapeGroup>();
+        nested->add(make_unique<Text>(1, 2, "nested"));
+        scene.add(move(nested));
+
+        return scene;
+    }
+
+    const string expected_output = "Rendering text 'text' at: [10, 20]\n"
+                                   "Rendering text 'other text' at: [-5, 0]\n"
+                                   "Rendering text 'nested' at: [1, 2]\n";
+}
+
+TEST_CASE("RenderBuffer - frame is written to sink at once")
+{
+    ShapeGroup scene = create_scene();
+
+    RenderBuffer frame;
+    scene.render(frame);
+    REQUIRE(frame.size() == expected_output.size());
+
+    StringSink sink;
+    frame.submit(sink);
+
+    REQUIRE(sink.str() == expected_output);
+    REQUIRE(frame.empty());
+}
+
+TEST_CASE("RenderBuffer - large frames are split into chunks")
+{
+    RenderBuffer frame;
+    string expected;
+    for (int i = 0; i < 10'000; ++i)
+    {
+        frame.render_text("label", i, -i);
+        expected += "Rendering text 'label' at: [" + to_string(i) + ", " + to_string(-i) + "]\n";
+    }
+
+    RenderBuffer other;
+    other.render_text(string(100'000, 'x'), 0, 0);
+    expected += "Rendering text '" + string(100'000, 'x') + "' at: [0, 0]\n";
+    frame.append(move(other));
+
+    REQUIRE(frame.str() == expected);
+}
+
+TEST_CASE("RenderBuffer - small frames reserve little memory")
+{
+    RenderBuffer frame;
+    frame.render_text("label", 1, 2);
+    REQUIRE(frame.capacity() < 1024);
+
+    for (int i = 0; i < 10'000; ++i)
+        frame.render_text("label", i, -i);
+    REQUIRE(frame.capacity() < 2 * frame.size());
+}
+
+TEST_CASE("draw keeps the text output format")
+{
+    ShapeGroup scene = create_scene();
+
+    ostringstream out;
+    auto* old_buffer = cout.rdbuf(out.rdbuf());
+    scene.draw();
+    cout.rdbuf(old_buffer);
+
+    REQUIRE(out.str() == expected_output);
+}
+
+#ifdef RENDER_SINK_HAS_WRITEV
+TEST_CASE("FdSink - vectored write to file descriptor")
+{
+    unique_ptr<FILE, int (*)(FILE*)> file {tmpfile(), &fclose};
+    REQUIRE(file != nullptr);
+
+    RenderBuffer frame;
+    create_scene().render(frame);
+    frame.render_text(string(200'000, 'y'), 3, 4);
+    const string expected = frame.str();
+
+    FdSink sink {fileno(file.get())};
+    frame.submit(sink);
+
+    rewind(file.get());
+    string written(expected.size() + 1, '\0');
+    written.resize(fread(&written[0], 1, written.size(), file.get()));
+
+    REQUIRE(written == expected);
+}
+#endif
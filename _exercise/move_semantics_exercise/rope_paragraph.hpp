@@ -0,0 +1,329 @@
+#ifndef ROPE_PARAGRAPH_HPP_
+#define ROPE_PARAGRAPH_HPP_
+
+#include "paragraph.hpp"
+#include "render_sink.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace LegacyCode
+{
+    // Paragraph for large, frequently edited documents
+    // - text is kept in an immutable, height-balanced tree of chunks
+    // - insert/erase/substr are O(log n) and share unchanged chunks with other versions
+    // - copies are O(1)
+    // - get_paragraph() joins the chunks on the first call after an edit (not thread-safe) and caches the result
+    class RopeParagraph
+    {
+    public:
+        static constexpr size_t max_chunk_size = 256;
+
+    private:
+        struct Node;
+        using NodePtr = std::shared_ptr<const Node>;
+
+        struct Node
+        {
+            NodePtr left, right; // both empty for leaves
+            std::string chunk;   // used only by leaves
+            size_t length;
+            int height;
+
+            Node(const char* txt, size_t len)
+                : chunk(txt, len)
+                , length {len}
+                , height {0}
+            {
+            }
+
+            Node(NodePtr l, NodePtr r)
+                : left {std::move(l)}
+                , right {std::move(r)}
+                , length {left->length + right->length}
+                , height {1 + std::max(left->height, right->height)}
+            {
+            }
+
+            bool is_leaf() const noexcept
+            {
+                return left == nullptr;
+            }
+        };
+
+        NodePtr root_;
+        mutable std::shared_ptr<const std::string> flat_; // joined text, reset by every edit
+
+        static size_t length_of(const NodePtr& node) noexcept
+        {
+            return node ? node->length : 0;
+        }
+
+        static int height_of(const NodePtr& node) noexcept
+        {
+            return node ? node->height : -1;
+        }
+
+        static NodePtr make_leaf(const char* txt, size_t length)
+        {
+            return length == 0 ? nullptr : std::make_shared<const Node>(txt, length);
+        }
+
+        static NodePtr make_concat(NodePtr left, NodePtr right)
+        {
+            return std::make_shared<const Node>(std::move(left), std::move(right));
+        }
+
+        static NodePtr build(const char* txt, size_t length)
+        {
+            if (length <= max_chunk_size)
+                return make_leaf(txt, length);
+
+            const size_t chunks = (length + max_chunk_size - 1) / max_chunk_size;
+            const size_t left_length = (chunks / 2) * max_chunk_size;
+
+            return make_concat(build(txt, left_length), build(txt + left_length, length - left_length));
+        }
+
+        // concatenates two balanced subtrees whose heights differ by at most 2
+        static NodePtr balance(NodePtr left, NodePtr right)
+        {
+            if (height_of(right) > height_of(left) + 1)
+            {
+                if (height_of(right->left) > height_of(right->right))
+                {
+                    const NodePtr& mid = right->left;
+                    return make_concat(make_concat(std::move(left), mid->left), make_concat(mid->right, right->right));
+                }
+
+                return make_concat(make_concat(std::move(left), right->left), right->right);
+            }
+
+            if (height_of(left) > height_of(right) + 1)
+            {
+                if (height_of(left->right) > height_of(left->left))
+                {
+                    const NodePtr& mid = left->right;
+                    return make_concat(make_concat(left->left, mid->left), make_concat(mid->right, std::move(right)));
+                }
+
+                return make_concat(left->left, make_concat(left->right, std::move(right)));
+            }
+
+            return make_concat(std::move(left), std::move(right));
+        }
+
+        static NodePtr join(const NodePtr& left, const NodePtr& right)
+        {
+            if (!left)
+                return right;
+            if (!right)
+                return left;
+
+            if (left->is_leaf() && right->is_leaf() && left->length + right->length <= max_chunk_size)
+                return std::make_shared<const Node>((left->chunk + right->chunk).c_str(), left->length + right->length);
+
+            if (height_of(left) > height_of(right) + 1)
+                return balance(left->left, join(left->right, right));
+
+            if (height_of(right) > height_of(left) + 1)
+                return balance(join(left, right->left), right->right);
+
+            return make_concat(left, right);
+        }
+
+        static std::pair<NodePtr, NodePtr> split(const NodePtr& node, size_t pos)
+        {
+            if (pos == 0)
+                return {nullptr, node};
+            if (pos >= length_of(node))
+                return {node, nullptr};
+
+            if (node->is_leaf())
+            {
+                const char* txt = node->chunk.data();
+                return {make_leaf(txt, pos), make_leaf(txt + pos, node->length - pos)};
+            }
+
+            const size_t left_length = node->left->length;
+
+            if (pos < left_length)
+            {
+                auto parts = split(node->left, pos);
+                return {std::move(parts.first), join(parts.second, node->right)};
+            }
+
+            if (pos == left_length)
+                return {node->left, node->right};
+
+            auto parts = split(node->right, pos - left_length);
+            return {join(node->left, parts.first), std::move(parts.second)};
+        }
+
+        template <typename TFunction>
+        static void for_each_chunk(const NodePtr& node, TFunction& f)
+        {
+            if (!node)
+                return;
+
+            if (node->is_leaf())
+            {
+                f(node->chunk.data(), node->length);
+                return;
+            }
+
+            for_each_chunk(node->left, f);
+            for_each_chunk(node->right, f);
+        }
+
+        explicit RopeParagraph(NodePtr root)
+            : root_ {std::move(root)}
+        {
+        }
+
+        void check_position(size_t pos) const
+        {
+            if (pos > length())
+                throw std::out_of_range("RopeParagraph: position out of range");
+        }
+
+    public:
+        RopeParagraph()
+            : RopeParagraph("Default text!")
+        {
+        }
+
+        RopeParagraph(const char* txt)
+            : RopeParagraph(txt, std::strlen(txt))
+        {
+        }
+
+        RopeParagraph(const char* txt, size_t length)
+            : root_ {build(txt, length)}
+        {
+        }
+
+        RopeParagraph(const RopeParagraph&) = default;
+        RopeParagraph& operator=(const RopeParagraph&) = default;
+        RopeParagraph(RopeParagraph&&) noexcept = default;
+        RopeParagraph& operator=(RopeParagraph&&) noexcept = default;
+
+        void set_paragraph(const char* txt)
+        {
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            root_ = build(txt, length);
+            flat_.reset();
+        }
+
+        const char* get_paragraph() const
+        {
+            if (!flat_)
+                flat_ = std::make_shared<const std::string>(str());
+
+            return flat_->c_str();
+        }
+
+        size_t length() const noexcept
+        {
+            return length_of(root_);
+        }
+
+        int depth() const noexcept
+        {
+            return height_of(root_) + 1;
+        }
+
+        char at(size_t pos) const
+        {
+            if (pos >= length())
+                throw std::out_of_range("RopeParagraph: position out of range");
+
+            const Node* node = root_.get();
+            while (!node->is_leaf())
+            {
+                if (pos < node->left->length)
+                {
+                    node = node->left.get();
+                }
+                else
+                {
+                    pos -= node->left->length;
+                    node = node->right.get();
+                }
+            }
+
+            return node->chunk[pos];
+        }
+
+        void insert(size_t pos, const char* txt)
+        {
+            insert(pos, txt, std::strlen(txt));
+        }
+
+        void insert(size_t pos, const char* txt, size_t length)
+        {
+            check_position(pos);
+
+            auto parts = split(root_, pos);
+            root_ = join(join(parts.first, build(txt, length)), parts.second);
+            flat_.reset();
+        }
+
+        void erase(size_t pos, size_t count)
+        {
+            check_position(pos);
+
+            auto head = split(root_, pos);
+            auto tail = split(head.second, count);
+            root_ = join(head.first, tail.second);
+            flat_.reset();
+        }
+
+        RopeParagraph substr(size_t pos, size_t count) const
+        {
+            check_position(pos);
+
+            auto head = split(root_, pos);
+            return RopeParagraph(split(head.second, count).first);
+        }
+
+        // calls f(const char* chunk, size_t length) for every chunk in text order
+        template <typename TFunction>
+        void for_each_chunk(TFunction f) const
+        {
+            for_each_chunk(root_, f);
+        }
+
+        std::string str() const
+        {
+            std::string result;
+            result.reserve(length());
+            for_each_chunk([&result](const char* chunk, size_t length) { result.append(chunk, length); });
+
+            return result;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text_parts(
+                [this](RenderBuffer& text) {
+                    for_each_chunk([&text](const char* chunk, size_t length) { text.append(std::string_view(chunk, length)); });
+                },
+                posx, posy);
+        }
+    };
+}
+
+using RopeText = BasicText<LegacyCode::RopeParagraph>;
+
+#endif /*ROPE_PARAGRAPH_HPP_*/
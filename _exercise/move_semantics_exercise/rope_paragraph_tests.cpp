@@ -0,0 +1,104 @@
+#include "catch.hpp"
+#include "rope_paragraph.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("RopeParagraph - edits")
+{
+    LegacyCode::RopeParagraph rope("Hello world");
+
+    rope.insert(5, ",");
+    rope.insert(rope.length(), "!");
+    REQUIRE(rope.str() == "Hello, world!"s);
+
+    rope.erase(0, 7);
+    REQUIRE(rope.str() == "world!"s);
+    REQUIRE(rope.at(1) == 'o');
+
+    REQUIRE(rope.substr(1, 3).str() == "orl"s);
+    REQUIRE_THROWS_AS(rope.insert(100, "x"), std::out_of_range);
+}
+
+TEST_CASE("RopeParagraph - large document stays balanced")
+{
+    string expected(100'000, 'a');
+    LegacyCode::RopeParagraph rope(expected.c_str(), expected.size());
+
+    std::mt19937 rnd {42};
+    for (int i = 0; i < 2000; ++i)
+    {
+        const size_t pos = rnd() % (expected.size() + 1);
+
+        if (i % 3 == 0)
+        {
+            const size_t count = rnd() % 50;
+            rope.erase(pos, count);
+            expected.erase(pos, count);
+        }
+        else
+        {
+            const string txt = "edit-" + to_string(i);
+            rope.insert(pos, txt.c_str());
+            expected.insert(pos, txt);
+        }
+    }
+
+    REQUIRE(rope.length() == expected.size());
+    REQUIRE(rope.str() == expected);
+    REQUIRE(rope.depth() < 30);
+}
+
+TEST_CASE("RopeParagraph - versions share unchanged text")
+{
+    string text(10'000, 'x');
+    LegacyCode::RopeParagraph original(text.c_str());
+
+    LegacyCode::RopeParagraph edited = original;
+    edited.insert(5000, "inserted");
+
+    REQUIRE(original.str() == text);
+    REQUIRE(edited.str() == text.insert(5000, "inserted"));
+
+    auto chunks_of = [](const LegacyCode::RopeParagraph& rope) {
+        vector<const char*> chunks;
+        rope.for_each_chunk([&chunks](const char* chunk, size_t) { chunks.push_back(chunk); });
+        return chunks;
+    };
+
+    const vector<const char*> original_chunks = chunks_of(original);
+    const vector<const char*> edited_chunks = chunks_of(edited);
+
+    // only the chunk split by the insert is not shared
+    const auto shared = count_if(original_chunks.begin(), original_chunks.end(), [&edited_chunks](const char* chunk) {
+        return find(edited_chunks.begin(), edited_chunks.end(), chunk) != edited_chunks.end();
+    });
+    REQUIRE(shared == static_cast<long>(original_chunks.size()) - 1);
+}
+
+TEST_CASE("RopeParagraph - render_at streams chunks")
+{
+    string text(1000, 'y');
+    LegacyCode::RopeParagraph rope(text.c_str());
+
+    RenderBuffer frame;
+    rope.render_at(frame, 1, 2);
+
+    REQUIRE(frame.str() == "Rendering text '" + text + "' at: [1, 2]\n");
+}
+
+TEST_CASE("RopeText")
+{
+    RopeText t {1, 2, "Hello world"};
+    REQUIRE(t.text() == "Hello world"s);
+
+    t.set_text("Hello rope");
+    REQUIRE(t.text_view() == "Hello rope");
+
+    RenderBuffer frame;
+    t.render(frame);
+    REQUIRE(frame.str() == "Rendering text 'Hello rope' at: [1, 2]\n");
+}
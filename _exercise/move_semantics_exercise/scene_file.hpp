@@ -0,0 +1,454 @@
+#ifndef SCENE_FILE_HPP_
+#define SCENE_FILE_HPP_
+
+#include "paragraph.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCENE_FILE_HAS_MMAP
+#endif
+
+namespace LegacyCode
+{
+    struct BorrowText
+    {
+    };
+
+    // passed to ParagraphView to refer to an external text instead of copying it
+    constexpr BorrowText borrow_text {};
+
+    // Paragraph that refers to a null-terminated text owned by someone else (e.g. a mapped file);
+    // it makes its own copy only when the text is changed
+    class ParagraphView
+    {
+        const char* text_;
+        size_t length_;
+        std::unique_ptr<char[]> owned_;
+
+        void assign_copy(const char* txt, size_t length)
+        {
+            auto copy = std::make_unique<char[]>(length + 1);
+            std::memcpy(copy.get(), txt, length);
+            copy[length] = '\0';
+
+            owned_ = std::move(copy);
+            text_ = owned_.get();
+            length_ = length;
+        }
+
+    public:
+        ParagraphView()
+            : text_ {"Default text!"}
+            , length_ {13}
+        {
+        }
+
+        ParagraphView(const char* txt, size_t length)
+        {
+            assign_copy(txt, length);
+        }
+
+        // txt[length] must be '\0' and the text must outlive the paragraph
+        ParagraphView(const char* txt, size_t length, BorrowText) noexcept
+            : text_ {txt}
+            , length_ {length}
+        {
+        }
+
+        ParagraphView(const ParagraphView& other)
+            : text_ {other.text_}
+            , length_ {other.length_}
+        {
+            if (other.owned_)
+                assign_copy(other.text_, other.length_);
+        }
+
+        ParagraphView& operator=(const ParagraphView& other)
+        {
+            if (this != &other)
+            {
+                ParagraphView temp(other);
+                *this = std::move(temp);
+            }
+            return *this;
+        }
+
+        ParagraphView(ParagraphView&& other) noexcept
+            : text_ {other.text_}
+            , length_ {other.length_}
+            , owned_ {std::move(other.owned_)}
+        {
+            other.text_ = nullptr;
+            other.length_ = 0;
+        }
+
+        ParagraphView& operator=(ParagraphView&& other) noexcept
+        {
+            if (this != &other)
+            {
+                text_ = other.text_;
+                length_ = other.length_;
+                owned_ = std::move(other.owned_);
+
+                other.text_ = nullptr;
+                other.length_ = 0;
+            }
+            return *this;
+        }
+
+        void set_paragraph(const char* txt)
+        {
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            assign_copy(txt, length);
+        }
+
+        const char* get_paragraph() const noexcept
+        {
+            return text_;
+        }
+
+        size_t length() const noexcept
+        {
+            return length_;
+        }
+
+        bool is_borrowed() const noexcept
+        {
+            return text_ != nullptr && !owned_;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text(std::string_view(text_ ? text_ : "", length_), posx, posy);
+        }
+    };
+}
+
+using MappedText = BasicText<LegacyCode::ParagraphView>;
+
+// Binary scene file
+// - header, then flat arrays with one entry per node (tree stored in pre-order)
+// - node_info: number of children for groups, text_node for texts
+// - all texts in one blob, every text followed by '\0'
+namespace SceneFile
+{
+    constexpr char magic[8] = {'S', 'C', 'E', 'N', 'E', 'B', 'I', 'N'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t byte_order_mark = 0x01020304;
+    constexpr std::uint32_t text_node = 0xFFFFFFFF;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order_mark;
+        std::uint64_t node_count;
+        std::uint64_t blob_size;
+        std::uint64_t node_info_offset;   // uint32_t[node_count]
+        std::uint64_t xs_offset;          // int32_t[node_count]
+        std::uint64_t ys_offset;          // int32_t[node_count]
+        std::uint64_t text_offset_offset; // uint64_t[node_count]
+        std::uint64_t text_length_offset; // uint32_t[node_count]
+        std::uint64_t blob_offset;
+    };
+
+    class FormatError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    namespace Detail
+    {
+        // node_info of a group - text_node and above cannot be stored
+        inline std::uint32_t group_node_info(size_t child_count)
+        {
+            if (child_count >= text_node)
+                throw std::length_error("SceneFile: group has too many children to be saved");
+
+            return static_cast<std::uint32_t>(child_count);
+        }
+
+        inline std::uint32_t stored_text_length(size_t length)
+        {
+            if (length > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("SceneFile: text is too long to be saved");
+
+            return static_cast<std::uint32_t>(length);
+        }
+
+        struct Arrays
+        {
+            std::vector<std::uint32_t> node_info;
+            std::vector<std::int32_t> xs, ys;
+            std::vector<std::uint64_t> text_offsets;
+            std::vector<std::uint32_t> text_lengths;
+            std::string blob;
+
+            void add_node(std::uint32_t info, Point p, std::uint64_t text_offset, std::uint32_t text_length)
+            {
+                node_info.push_back(info);
+                xs.push_back(p.x);
+                ys.push_back(p.y);
+                text_offsets.push_back(text_offset);
+                text_lengths.push_back(text_length);
+            }
+
+            void add_shape(const Shape& shape)
+            {
+                if (const auto* group = dynamic_cast<const ShapeGroup*>(&shape))
+                {
+                    add_node(group_node_info(group->shapes().size()), Point {0, 0}, 0, 0);
+                    for (const auto& child : group->shapes())
+                        add_shape(*child);
+                }
+                else if (const auto* text = dynamic_cast<const TextShape*>(&shape))
+                {
+                    const std::string_view txt = text->text_view();
+                    add_node(text_node, *text->anchor(), blob.size(), stored_text_length(txt.size()));
+                    blob.append(txt);
+                    blob.push_back('\0');
+                }
+                else
+                {
+                    throw std::invalid_argument("SceneFile: only ShapeGroups and text shapes can be saved");
+                }
+            }
+        };
+
+        inline std::uint64_t align8(std::uint64_t offset)
+        {
+            return (offset + 7) & ~std::uint64_t(7);
+        }
+
+        template <typename T>
+        void write_array(std::ofstream& out, std::uint64_t offset, const std::vector<T>& values)
+        {
+            out.seekp(static_cast<std::streamoff>(offset));
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+        }
+    }
+
+    inline void write(const ShapeGroup& scene, const std::string& path)
+    {
+        Detail::Arrays arrays;
+        arrays.add_shape(scene);
+
+        const std::uint64_t n = arrays.node_info.size();
+
+        Header header {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.byte_order_mark = byte_order_mark;
+        header.node_count = n;
+        header.blob_size = arrays.blob.size();
+        header.node_info_offset = Detail::align8(sizeof(Header));
+        header.xs_offset = Detail::align8(header.node_info_offset + n * sizeof(std::uint32_t));
+        header.ys_offset = Detail::align8(header.xs_offset + n * sizeof(std::int32_t));
+        header.text_offset_offset = Detail::align8(header.ys_offset + n * sizeof(std::int32_t));
+        header.text_length_offset = Detail::align8(header.text_offset_offset + n * sizeof(std::uint64_t));
+        header.blob_offset = Detail::align8(header.text_length_offset + n * sizeof(std::uint32_t));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("SceneFile: cannot open " + path);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        Detail::write_array(out, header.node_info_offset, arrays.node_info);
+        Detail::write_array(out, header.xs_offset, arrays.xs);
+        Detail::write_array(out, header.ys_offset, arrays.ys);
+        Detail::write_array(out, header.text_offset_offset, arrays.text_offsets);
+        Detail::write_array(out, header.text_length_offset, arrays.text_lengths);
+        out.seekp(static_cast<std::streamoff>(header.blob_offset));
+        out.write(arrays.blob.data(), static_cast<std::streamsize>(arrays.blob.size()));
+
+        if (!out)
+            throw std::runtime_error("SceneFile: cannot write " + path);
+    }
+
+#ifdef SCENE_FILE_HAS_MMAP
+    // Scene loaded from a memory-mapped file - texts of MappedText shapes point into the mapping,
+    // so the scene must outlive every borrowed text
+    class MappedScene
+    {
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        ShapeGroup root_;
+
+        const Header& header() const noexcept
+        {
+            return *reinterpret_cast<const Header*>(data_);
+        }
+
+        template <typename T>
+        const T* array_at(std::uint64_t offset, std::uint64_t count) const
+        {
+            if (offset % alignof(T) != 0 || offset > size_ || count > (size_ - offset) / sizeof(T))
+                throw FormatError("SceneFile: array out of file bounds");
+
+            return reinterpret_cast<const T*>(data_ + offset);
+        }
+
+        void validate_header() const
+        {
+            if (size_ < sizeof(Header) || std::memcmp(header().magic, magic, sizeof(magic)) != 0)
+                throw FormatError("SceneFile: not a scene file");
+            if (header().version != version)
+                throw FormatError("SceneFile: unsupported version " + std::to_string(header().version));
+            if (header().byte_order_mark != byte_order_mark)
+                throw FormatError("SceneFile: file written with different byte order");
+        }
+
+        void build()
+        {
+            const Header& h = header();
+            const std::uint64_t n = h.node_count;
+
+            const auto* node_info = array_at<std::uint32_t>(h.node_info_offset, n);
+            const auto* xs = array_at<std::int32_t>(h.xs_offset, n);
+            const auto* ys = array_at<std::int32_t>(h.ys_offset, n);
+            const auto* text_offsets = array_at<std::uint64_t>(h.text_offset_offset, n);
+            const auto* text_lengths = array_at<std::uint32_t>(h.text_length_offset, n);
+            const char* blob = array_at<char>(h.blob_offset, h.blob_size);
+
+            if (n == 0 || node_info[0] == text_node)
+                throw FormatError("SceneFile: root must be a group");
+
+            struct Pending
+            {
+                ShapeGroup* group;
+                std::uint32_t remaining;
+            };
+
+            std::vector<Pending> stack {{&root_, node_info[0]}};
+
+            for (std::uint64_t i = 1; i < n; ++i)
+            {
+                while (!stack.empty() && stack.back().remaining == 0)
+                    stack.pop_back();
+                if (stack.empty())
+                    throw FormatError("SceneFile: node outside of the scene tree");
+
+                ShapeGroup& parent = *stack.back().group;
+                --stack.back().remaining;
+
+                if (node_info[i] == text_node)
+                {
+                    const std::uint64_t offset = text_offsets[i];
+                    const std::uint32_t length = text_lengths[i];
+                    if (offset >= h.blob_size || length >= h.blob_size - offset || blob[offset + length] != '\0')
+                        throw FormatError("SceneFile: text out of blob bounds");
+
+                    parent.add(std::make_unique<MappedText>(xs[i], ys[i], std::string_view(blob + offset, length), LegacyCode::borrow_text));
+                }
+                else
+                {
+                    auto group = std::make_unique<ShapeGroup>();
+                    ShapeGroup* group_ptr = group.get();
+                    parent.add(std::move(group));
+                    stack.push_back({group_ptr, node_info[i]});
+                }
+            }
+
+            for (const auto& pending : stack)
+            {
+                if (pending.remaining != 0)
+                    throw FormatError("SceneFile: missing nodes");
+            }
+        }
+
+        void unmap() noexcept
+        {
+            if (data_ != nullptr)
+                ::munmap(const_cast<char*>(data_), size_);
+
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+    public:
+        explicit MappedScene(const std::string& path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("SceneFile: cannot open " + path);
+
+            struct stat info {};
+            if (::fstat(fd, &info) != 0 || info.st_size == 0)
+            {
+                ::close(fd);
+                throw FormatError("SceneFile: empty or unreadable file " + path);
+            }
+
+            void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (mapping == MAP_FAILED)
+                throw std::runtime_error("SceneFile: cannot map " + path);
+
+            data_ = static_cast<const char*>(mapping);
+            size_ = static_cast<size_t>(info.st_size);
+
+            try
+            {
+                validate_header();
+                build();
+            }
+            catch (...)
+            {
+                root_.clear();
+                unmap();
+                throw;
+            }
+        }
+
+        MappedScene(const MappedScene&) = delete;
+        MappedScene& operator=(const MappedScene&) = delete;
+
+        ~MappedScene()
+        {
+            root_.clear(); // borrowed texts go before the mapping
+            unmap();
+        }
+
+        ShapeGroup& root() noexcept
+        {
+            return root_;
+        }
+
+        const ShapeGroup& root() const noexcept
+        {
+            return root_;
+        }
+
+        const char* data() const noexcept
+        {
+            return data_;
+        }
+
+        size_t size() const noexcept
+        {
+            return size_;
+        }
+    };
+#endif
+}
+
+#endif /*SCENE_FILE_HPP_*/
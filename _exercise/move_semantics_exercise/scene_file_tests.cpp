@@ -0,0 +1,109 @@
+#include "catch.hpp"
+#include "cow_paragraph.hpp"
+#include "scene_file.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+#ifdef SCENE_FILE_HAS_MMAP
+
+namespace
+{
+    struct TempFile
+    {
+        string path = (filesystem::temp_directory_path() / "scene_file_tests.bin").string();
+
+        ~TempFile()
+        {
+            remove(path.c_str());
+        }
+    };
+
+    ShapeGroup create_scene()
+    {
+        ShapeGroup scene;
+        scene.add(make_unique<Text>(10, 20, "text"));
+        scene.add(make_unique<CowText>(-5, 7, string(300, 'c')));
+
+        auto nested = make_unique<ShapeGroup>();
+        nested->add(make_unique<Text>(1, 2, "nested"));
+        nested->add(make_unique<ShapeGroup>());
+        nested->add(make_unique<Text>(3, 4, ""));
+        scene.add(move(nested));
+        scene.add(make_unique<Text>(5, 6, "last"));
+
+        return scene;
+    }
+}
+
+TEST_CASE("SceneFile - write and map")
+{
+    TempFile file;
+    const ShapeGroup scene = create_scene();
+    SceneFile::write(scene, file.path);
+
+    SceneFile::MappedScene mapped {file.path};
+
+    RenderBuffer expected, loaded;
+    scene.render(expected);
+    mapped.root().render(loaded);
+    REQUIRE(loaded.str() == expected.str());
+
+    SECTION("texts point into the mapping")
+    {
+        const auto& txt = dynamic_cast<const MappedText&>(*mapped.root().shapes()[0]);
+
+        REQUIRE(txt.paragraph().is_borrowed());
+        REQUIRE(txt.text_view().data() >= mapped.data());
+        REQUIRE(txt.text_view().data() < mapped.data() + mapped.size());
+    }
+
+    SECTION("changed text gets its own copy")
+    {
+        auto& txt = dynamic_cast<MappedText&>(*mapped.root().shapes()[0]);
+        txt.set_text("changed");
+
+        REQUIRE_FALSE(txt.paragraph().is_borrowed());
+        REQUIRE(txt.text() == "changed"s);
+    }
+}
+
+TEST_CASE("SceneFile - sizes that do not fit in 32 bits are rejected by the writer")
+{
+    REQUIRE(SceneFile::Detail::group_node_info(0xFFFFFFFE) == 0xFFFFFFFE);
+    REQUIRE_THROWS_AS(SceneFile::Detail::group_node_info(SceneFile::text_node), std::length_error);
+
+    REQUIRE(SceneFile::Detail::stored_text_length(0xFFFFFFFF) == 0xFFFFFFFF);
+    if constexpr (sizeof(size_t) > sizeof(uint32_t))
+        REQUIRE_THROWS_AS(SceneFile::Detail::stored_text_length(size_t(1) << 32), std::length_error);
+}
+
+TEST_CASE("SceneFile - invalid files are rejected")
+{
+    TempFile file;
+    SceneFile::write(create_scene(), file.path);
+
+    SECTION("unsupported version")
+    {
+        fstream f(file.path, ios::binary | ios::in | ios::out);
+        const uint32_t future_version = SceneFile::version + 1;
+        f.seekp(offsetof(SceneFile::Header, version));
+        f.write(reinterpret_cast<const char*>(&future_version), sizeof(future_version));
+        f.close();
+
+        REQUIRE_THROWS_AS(SceneFile::MappedScene(file.path), SceneFile::FormatError);
+    }
+
+    SECTION("truncated file")
+    {
+        filesystem::resize_file(file.path, filesystem::file_size(file.path) - 10);
+
+        REQUIRE_THROWS_AS(SceneFile::MappedScene(file.path), SceneFile::FormatError);
+    }
+}
+
+#endif
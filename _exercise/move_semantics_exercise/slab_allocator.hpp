@@ -0,0 +1,334 @@
+#ifndef SLAB_ALLOCATOR_HPP_
+#define SLAB_ALLOCATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace LegacyCode
+{
+    struct SlabStats
+    {
+        // slabs carved from the global heap so far - slabs are never returned to it, so this is also the number
+        // of slabs the allocator holds (a slab whose blocks are all free still counts)
+        size_t slabs_carved;
+        size_t thread_cache_hits;  // allocations served without touching the shared pool
+        size_t shared_pool_hits;   // allocations that had to refill the thread cache
+        size_t bytes_held;         // slabs + live oversized blocks
+        size_t peak_bytes_held;
+    };
+
+    // Size-class slab allocator for text buffers
+    // - blocks of 32 B .. 4 KiB are carved from 64 KiB slabs
+    // - every thread keeps a small free list per size class
+    // - free lists are refilled from and returned to the shared pool in batches
+    // - bigger requests go straight to the global heap
+    // - slabs are kept for reuse until the end of the process, even when all their blocks are free
+    class SlabAllocator
+    {
+    public:
+        static constexpr size_t slab_size = 64 * 1024;
+        static constexpr size_t size_class_count = 8;
+        static constexpr size_t min_block_size = 32;
+        static constexpr size_t max_block_size = min_block_size << (size_class_count - 1);
+        static constexpr size_t batch_size = 32;
+        static constexpr size_t thread_cache_limit = 2 * batch_size;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct SharedPool
+        {
+            std::mutex mtx;
+            FreeBlock* free_list = nullptr;
+        };
+
+        struct ThreadCache
+        {
+            std::array<FreeBlock*, size_class_count> free_lists {};
+            std::array<size_t, size_class_count> counts {};
+            std::atomic<size_t> hits {0};
+            std::atomic<size_t> refills {0};
+        };
+
+        // owns the cache of the current thread and hands it back to the shared pool at thread exit
+        struct ThreadCacheOwner
+        {
+            ThreadCache cache;
+
+            ThreadCacheOwner()
+            {
+                SlabAllocator& allocator = instance();
+                {
+                    std::lock_guard<std::mutex> lk {allocator.registry_mtx_};
+                    allocator.live_caches_.push_back(&cache);
+                }
+                tls_cache() = &cache;
+            }
+
+            ~ThreadCacheOwner()
+            {
+                tls_cache() = nullptr;
+                tls_cache_destroyed() = true;
+                instance().retire(cache);
+            }
+        };
+
+        std::array<SharedPool, size_class_count> pools_;
+
+        std::mutex registry_mtx_;
+        std::vector<ThreadCache*> live_caches_;
+        size_t retired_hits_ = 0;
+        size_t retired_refills_ = 0;
+
+        std::atomic<size_t> slabs_carved_ {0};
+        std::atomic<size_t> bytes_held_ {0};
+        std::atomic<size_t> peak_bytes_held_ {0};
+
+        SlabAllocator() = default;
+
+        static ThreadCache*& tls_cache() noexcept
+        {
+            static thread_local ThreadCache* cache = nullptr;
+            return cache;
+        }
+
+        static bool& tls_cache_destroyed() noexcept
+        {
+            static thread_local bool destroyed = false;
+            return destroyed;
+        }
+
+        static ThreadCache* thread_cache()
+        {
+            ThreadCache* cache = tls_cache();
+
+            if (cache == nullptr && !tls_cache_destroyed())
+            {
+                static thread_local ThreadCacheOwner owner;
+                cache = tls_cache();
+            }
+
+            return cache;
+        }
+
+        static size_t size_class(size_t size) noexcept
+        {
+            size_t cls = 0;
+            for (size_t block = min_block_size; block < size; block <<= 1)
+                ++cls;
+
+            return cls;
+        }
+
+        void add_bytes_held(size_t bytes) noexcept
+        {
+            const size_t held = bytes_held_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+            size_t peak = peak_bytes_held_.load(std::memory_order_relaxed);
+            while (held > peak && !peak_bytes_held_.compare_exchange_weak(peak, held, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // carves a new slab; must be called with the pool's mutex locked
+        FreeBlock* carve_slab(size_t cls)
+        {
+            const size_t block_size = min_block_size << cls;
+            char* slab = static_cast<char*>(::operator new(slab_size));
+
+            slabs_carved_.fetch_add(1, std::memory_order_relaxed);
+            add_bytes_held(slab_size);
+
+            FreeBlock* head = nullptr;
+            for (size_t offset = slab_size; offset >= block_size; offset -= block_size)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset - block_size);
+                block->next = head;
+                head = block;
+            }
+
+            return head;
+        }
+
+        // moves up to batch_size blocks from the shared pool to the thread cache
+        void refill(ThreadCache& cache, size_t cls)
+        {
+            SharedPool& pool = pools_[cls];
+            std::lock_guard<std::mutex> lk {pool.mtx};
+
+            if (pool.free_list == nullptr)
+                pool.free_list = carve_slab(cls);
+
+            FreeBlock* first = pool.free_list;
+            FreeBlock* last = first;
+            size_t count = 1;
+            while (count < batch_size && last->next != nullptr)
+            {
+                last = last->next;
+                ++count;
+            }
+
+            pool.free_list = last->next;
+            last->next = cache.free_lists[cls];
+            cache.free_lists[cls] = first;
+            cache.counts[cls] += count;
+        }
+
+        // returns a batch of blocks from the thread cache to the shared pool
+        void flush(ThreadCache& cache, size_t cls, size_t count) noexcept
+        {
+            FreeBlock* first = cache.free_lists[cls];
+            if (first == nullptr || count == 0)
+                return;
+
+            FreeBlock* last = first;
+            for (size_t i = 1; i < count && last->next != nullptr; ++i)
+                last = last->next;
+
+            cache.free_lists[cls] = last->next;
+            cache.counts[cls] -= count;
+
+            SharedPool& pool = pools_[cls];
+            std::lock_guard<std::mutex> lk {pool.mtx};
+            last->next = pool.free_list;
+            pool.free_list = first;
+        }
+
+        void retire(ThreadCache& cache) noexcept
+        {
+            for (size_t cls = 0; cls < size_class_count; ++cls)
+                flush(cache, cls, cache.counts[cls]);
+
+            std::lock_guard<std::mutex> lk {registry_mtx_};
+            retired_hits_ += cache.hits.load(std::memory_order_relaxed);
+            retired_refills_ += cache.refills.load(std::memory_order_relaxed);
+            live_caches_.erase(std::find(live_caches_.begin(), live_caches_.end(), &cache));
+        }
+
+        static void count(std::atomic<size_t>& counter) noexcept
+        {
+            // only the owning thread writes its counters
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+    public:
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        // intentionally never destroyed - buffers of static objects may be released after main()
+        static SlabAllocator& instance()
+        {
+            static SlabAllocator* allocator = new SlabAllocator();
+            return *allocator;
+        }
+
+        // size of the block that serves a request of given size
+        static size_t block_size(size_t size) noexcept
+        {
+            return size > max_block_size ? size : min_block_size << size_class(size);
+        }
+
+        void* allocate(size_t size)
+        {
+            if (size > max_block_size)
+            {
+                void* ptr = ::operator new(size);
+                add_bytes_held(size);
+                return ptr;
+            }
+
+            const size_t cls = size_class(size);
+            ThreadCache* cache = thread_cache();
+
+            if (cache == nullptr) // thread is already shutting down
+            {
+                SharedPool& pool = pools_[cls];
+                std::lock_guard<std::mutex> lk {pool.mtx};
+
+                if (pool.free_list == nullptr)
+                    pool.free_list = carve_slab(cls);
+
+                FreeBlock* block = pool.free_list;
+                pool.free_list = block->next;
+                return block;
+            }
+
+            if (cache->free_lists[cls] == nullptr)
+            {
+                refill(*cache, cls);
+                count(cache->refills);
+            }
+            else
+            {
+                count(cache->hits);
+            }
+
+            FreeBlock* block = cache->free_lists[cls];
+            cache->free_lists[cls] = block->next;
+            --cache->counts[cls];
+
+            return block;
+        }
+
+        void deallocate(void* ptr, size_t size) noexcept
+        {
+            if (ptr == nullptr)
+                return;
+
+            if (size > max_block_size)
+            {
+                ::operator delete(ptr);
+                bytes_held_.fetch_sub(size, std::memory_order_relaxed);
+                return;
+            }
+
+            const size_t cls = size_class(size);
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            ThreadCache* cache = thread_cache();
+
+            if (cache == nullptr)
+            {
+                SharedPool& pool = pools_[cls];
+                std::lock_guard<std::mutex> lk {pool.mtx};
+                block->next = pool.free_list;
+                pool.free_list = block;
+                return;
+            }
+
+            block->next = cache->free_lists[cls];
+            cache->free_lists[cls] = block;
+
+            if (++cache->counts[cls] > thread_cache_limit)
+                flush(*cache, cls, batch_size);
+        }
+
+        SlabStats stats()
+        {
+            SlabStats result {};
+            result.slabs_carved = slabs_carved_.load(std::memory_order_relaxed);
+            result.bytes_held = bytes_held_.load(std::memory_order_relaxed);
+            result.peak_bytes_held = peak_bytes_held_.load(std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lk {registry_mtx_};
+            result.thread_cache_hits = retired_hits_;
+            result.shared_pool_hits = retired_refills_;
+            for (const ThreadCache* cache : live_caches_)
+            {
+                result.thread_cache_hits += cache->hits.load(std::memory_order_relaxed);
+                result.shared_pool_hits += cache->refills.load(std::memory_order_relaxed);
+            }
+
+            return result;
+        }
+    };
+}
+
+#endif /*SLAB_ALLOCATOR_HPP_*/
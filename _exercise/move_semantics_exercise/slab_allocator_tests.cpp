@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "paragraph.hpp"
+#include "slab_allocator.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using LegacyCode::SlabAllocator;
+
+TEST_CASE("SlabAllocator - size classes")
+{
+    REQUIRE(SlabAllocator::block_size(1) == 32);
+    REQUIRE(SlabAllocator::block_size(33) == 64);
+    REQUIRE(SlabAllocator::block_size(1024) == 1024);
+    REQUIRE(SlabAllocator::block_size(1025) == 2048);
+    REQUIRE(SlabAllocator::block_size(10'000) == 10'000);
+}
+
+TEST_CASE("SlabAllocator - freed blocks are reused from thread cache")
+{
+    SlabAllocator& allocator = SlabAllocator::instance();
+
+    void* block = allocator.allocate(100);
+    allocator.deallocate(block, 100);
+
+    const auto before = allocator.stats();
+    void* reused = allocator.allocate(100);
+    const auto after = allocator.stats();
+
+    REQUIRE(reused == block);
+    REQUIRE(after.thread_cache_hits == before.thread_cache_hits + 1);
+    REQUIRE(after.slabs_carved == before.slabs_carved);
+
+    allocator.deallocate(reused, 100);
+}
+
+TEST_CASE("SlabAllocator - oversized blocks are counted in held memory")
+{
+    SlabAllocator& allocator = SlabAllocator::instance();
+    const auto before = allocator.stats();
+
+    void* big = allocator.allocate(1'000'000);
+    REQUIRE(allocator.stats().bytes_held == before.bytes_held + 1'000'000);
+    REQUIRE(allocator.stats().peak_bytes_held >= before.bytes_held + 1'000'000);
+
+    allocator.deallocate(big, 1'000'000);
+    REQUIRE(allocator.stats().bytes_held == before.bytes_held);
+}
+
+TEST_CASE("SlabAllocator - paragraphs from many threads")
+{
+    const string long_text(1000, 'x');
+
+    vector<thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&long_text] {
+            for (int round = 0; round < 10; ++round)
+            {
+                vector<Text> texts;
+                for (int j = 0; j < 500; ++j)
+                    texts.emplace_back(j, round, long_text);
+            }
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    const auto stats = SlabAllocator::instance().stats();
+    REQUIRE(stats.slabs_carved > 0);
+    REQUIRE(stats.bytes_held >= stats.slabs_carved * SlabAllocator::slab_size);
+    REQUIRE(stats.thread_cache_hits > stats.shared_pool_hits);
+    REQUIRE(stats.peak_bytes_held >= stats.bytes_held);
+}
@@ -0,0 +1,202 @@
+#ifndef SPATIAL_SHAPE_GROUP_HPP_
+#define SPATIAL_SHAPE_GROUP_HPP_
+
+#include "paragraph.hpp"
+#include "render_sink.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct Rect
+{
+    int x, y;
+    int width, height;
+
+    bool contains(Point p) const noexcept
+    {
+        // 64-bit differences - p.x - x overflows int for distant points
+        return p.x >= x && std::int64_t(p.x) - x < width && p.y >= y && std::int64_t(p.y) - y < height;
+    }
+};
+
+// ShapeGroup with a uniform hash grid over the anchors of its children
+// - the grid is updated on add(), remove() and when a child moves
+// - render_in() visits only the cells overlapping the viewport
+// - shapes without an anchor (nested groups) are always visited;
+//   nested SpatialShapeGroups are culled recursively
+class SpatialShapeGroup : public ShapeGroup
+{
+    using CellKey = std::uint64_t;
+
+    int cell_size_;
+    std::unordered_map<CellKey, std::vector<Shape*>> cells_;
+    std::vector<Shape*> unanchored_;
+
+    int cell_coord(int value) const noexcept
+    {
+        // rounds towards negative infinity
+        return (value >= 0) ? value / cell_size_ : -((-(value + 1)) / cell_size_) - 1;
+    }
+
+    static CellKey key(int cx, int cy) noexcept
+    {
+        return (static_cast<CellKey>(static_cast<std::uint32_t>(cy)) << 32) | static_cast<std::uint32_t>(cx);
+    }
+
+    CellKey key_of(Point p) const noexcept
+    {
+        return key(cell_coord(p.x), cell_coord(p.y));
+    }
+
+    // last coordinate covered by a range - clamped to INT_MAX instead of overflowing
+    static int last_coord(int first, int length) noexcept
+    {
+        return static_cast<int>(std::min<std::int64_t>(std::int64_t(first) + length - 1, std::numeric_limits<int>::max()));
+    }
+
+    static void erase_from(std::vector<Shape*>& shapes, const Shape* shape)
+    {
+        auto pos = std::find(shapes.begin(), shapes.end(), shape);
+        if (pos != shapes.end())
+            shapes.erase(pos);
+    }
+
+    void unindex(Shape& shape, CellKey cell)
+    {
+        auto pos = cells_.find(cell);
+        if (pos == cells_.end())
+            return;
+
+        erase_from(pos->second, &shape);
+        if (pos->second.empty())
+            cells_.erase(pos);
+    }
+
+    static void render_culled(const Shape& shape, const Rect& viewport, RenderBuffer& frame)
+    {
+        if (const auto* spatial = dynamic_cast<const SpatialShapeGroup*>(&shape))
+            spatial->render_in(viewport, frame);
+        else
+            shape.render(frame);
+    }
+
+protected:
+    void child_added(Shape& shape) override
+    {
+        if (auto position = shape.anchor())
+            cells_[key_of(*position)].push_back(&shape);
+        else
+            unanchored_.push_back(&shape);
+    }
+
+    void child_removed(Shape& shape) override
+    {
+        if (auto position = shape.anchor())
+            unindex(shape, key_of(*position));
+        else
+            erase_from(unanchored_, &shape);
+    }
+
+    void child_moved(Shape& shape, Point old_anchor) override
+    {
+        const CellKey old_cell = key_of(old_anchor);
+        const CellKey new_cell = key_of(*shape.anchor());
+
+        if (old_cell != new_cell)
+        {
+            unindex(shape, old_cell);
+            cells_[new_cell].push_back(&shape);
+        }
+    }
+
+public:
+    explicit SpatialShapeGroup(int cell_size = 256)
+        : cell_size_ {cell_size}
+    {
+        if (cell_size <= 0)
+            throw std::invalid_argument("SpatialShapeGroup: cell size must be positive");
+    }
+
+    int cell_size() const noexcept
+    {
+        return cell_size_;
+    }
+
+    size_t cell_count() const noexcept
+    {
+        return cells_.size();
+    }
+
+    // renders shapes anchored inside the viewport, cell row by cell row
+    void render_in(const Rect& viewport, RenderBuffer& frame) const
+    {
+        if (viewport.width > 0 && viewport.height > 0)
+        {
+            const int first_cx = cell_coord(viewport.x);
+            const int last_cx = cell_coord(last_coord(viewport.x, viewport.width));
+            const int first_cy = cell_coord(viewport.y);
+            const int last_cy = cell_coord(last_coord(viewport.y, viewport.height));
+
+            auto render_cell = [&](const std::vector<Shape*>& shapes) {
+                for (const Shape* s : shapes)
+                {
+                    if (viewport.contains(*s->anchor()))
+                        s->render(frame);
+                }
+            };
+
+            const std::uint64_t columns = std::uint64_t(std::int64_t(last_cx) - first_cx + 1);
+            const std::uint64_t rows = std::uint64_t(std::int64_t(last_cy) - first_cy + 1);
+
+            if (columns <= cells_.size() && rows <= cells_.size() / columns) // columns * rows <= size without overflow
+            {
+                // 64-bit counters - ++cx would overflow for the last cell column at INT_MAX
+                for (std::int64_t cy = first_cy; cy <= last_cy; ++cy)
+                    for (std::int64_t cx = first_cx; cx <= last_cx; ++cx)
+                    {
+                        auto pos = cells_.find(key(static_cast<int>(cx), static_cast<int>(cy)));
+                        if (pos != cells_.end())
+                            render_cell(pos->second);
+                    }
+            }
+            else // viewport larger than the occupied part of the grid
+            {
+                std::vector<std::pair<std::pair<int, int>, const std::vector<Shape*>*>> visible_cells;
+                for (const auto& [cell, shapes] : cells_)
+                {
+                    const int cx = static_cast<std::int32_t>(static_cast<std::uint32_t>(cell));
+                    const int cy = static_cast<std::int32_t>(static_cast<std::uint32_t>(cell >> 32));
+
+                    if (cx >= first_cx && cx <= last_cx && cy >= first_cy && cy <= last_cy)
+                        visible_cells.push_back({{cy, cx}, &shapes});
+                }
+
+                std::sort(visible_cells.begin(), visible_cells.end(),
+                    [](const auto& a, const auto& b) { return a.first < b.first; });
+
+                for (const auto& cell : visible_cells)
+                    render_cell(*cell.second);
+            }
+        }
+
+        for (const Shape* s : unanchored_)
+            render_culled(*s, viewport, frame);
+    }
+
+    void draw_in(const Rect& viewport) const
+    {
+        RenderBuffer frame;
+        render_in(viewport, frame);
+
+        OstreamSink sink {std::cout};
+        frame.submit(sink);
+    }
+};
+
+#endif /*SPATIAL_SHAPE_GROUP_HPP_*/
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include "spatial_shape_group.hpp"
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    string rendered(const SpatialShapeGroup& scene, const Rect& viewport)
+    {
+        RenderBuffer frame;
+        scene.render_in(viewport, frame);
+        return frame.str();
+    }
+}
+
+TEST_CASE("SpatialShapeGroup - render_in culls shapes outside viewport")
+{
+    SpatialShapeGroup scene {100};
+    for (int y = 0; y < 1000; y += 10)
+        for (int x = 0; x < 1000; x += 10)
+            scene.add(make_unique<Text>(x, y, "t"));
+
+    scene.add(make_unique<Text>(-55, -5, "negative"));
+
+    REQUIRE(rendered(scene, Rect {495, 500, 20, 11}) == "Rendering text 't' at: [500, 500]\n"
+                                                        "Rendering text 't' at: [510, 500]\n"
+                                                        "Rendering text 't' at: [500, 510]\n"
+                                                        "Rendering text 't' at: [510, 510]\n");
+
+    REQUIRE(rendered(scene, Rect {-60, -10, 10, 10}) == "Rendering text 'negative' at: [-55, -5]\n");
+    REQUIRE(rendered(scene, Rect {2000, 2000, 100, 100}).empty());
+
+    SECTION("huge viewport visits only occupied cells")
+    {
+        RenderBuffer all;
+        scene.render(all);
+
+        REQUIRE(rendered(scene, Rect {-1'000'000, -1'000'000, 2'000'000, 2'000'000}).size() == all.size());
+    }
+}
+
+TEST_CASE("SpatialShapeGroup - index follows moves and removals")
+{
+    SpatialShapeGroup scene {64};
+    scene.add(make_unique<Text>(10, 10, "moving"));
+    scene.add(make_unique<Text>(20, 20, "removed"));
+
+    auto& moving = dynamic_cast<Text&>(*scene.shapes()[0]);
+    const Shape& removed = *scene.shapes()[1];
+
+    const Rect old_viewport {0, 0, 50, 50};
+    const Rect new_viewport {1000, 1000, 50, 50};
+
+    moving.move_to(1010, 1020);
+    moving.move_to(1020, 1020);
+    auto owned = scene.remove(removed);
+
+    REQUIRE(owned != nullptr);
+    REQUIRE(rendered(scene, old_viewport).empty());
+    REQUIRE(rendered(scene, new_viewport) == "Rendering text 'moving' at: [1020, 1020]\n");
+    REQUIRE(scene.cell_count() == 1);
+}
+
+TEST_CASE("SpatialShapeGroup - index follows assignments")
+{
+    SpatialShapeGroup scene {64};
+    scene.add(make_unique<Text>(10, 10, "assigned"));
+
+    auto& assigned = dynamic_cast<Text&>(*scene.shapes()[0]);
+    const Text far_away {1000, 1000, "copied"};
+
+    assigned = far_away;
+    REQUIRE(rendered(scene, Rect {1000, 1000, 10, 10}) == "Rendering text 'copied' at: [1000, 1000]\n");
+
+    assigned = Text {2000, 2000, "moved"};
+    REQUIRE(rendered(scene, Rect {1000, 1000, 10, 10}).empty());
+    REQUIRE(rendered(scene, Rect {2000, 2000, 10, 10}) == "Rendering text 'moved' at: [2000, 2000]\n");
+
+    scene.remove(assigned);
+    REQUIRE(scene.cell_count() == 0);
+}
+
+TEST_CASE("SpatialShapeGroup - extreme coordinates")
+{
+    const int max = numeric_limits<int>::max();
+    const int min = numeric_limits<int>::min();
+
+    SpatialShapeGroup scene {1};
+    scene.add(make_unique<Text>(max, max, "max"));
+    scene.add(make_unique<Text>(min, min, "min"));
+
+    REQUIRE(rendered(scene, Rect {max, max, 100, 100}) == "Rendering text 'max' at: [2147483647, 2147483647]\n");
+    REQUIRE(rendered(scene, Rect {min, min, 2, 2}) == "Rendering text 'min' at: [-2147483648, -2147483648]\n");
+    REQUIRE(rendered(scene, Rect {min, min, max, max}) == "Rendering text 'min' at: [-2147483648, -2147483648]\n");
+    REQUIRE(Rect {min, min, max, max}.contains(Point {max - 1, 0}) == false);
+}
+
+TEST_CASE("SpatialShapeGroup - nested groups")
+{
+    auto nested_spatial = make_unique<SpatialShapeGroup>();
+    nested_spatial->add(make_unique<Text>(5, 5, "visible"));
+    nested_spatial->add(make_unique<Text>(500, 500, "culled"));
+
+    auto nested_plain = make_unique<ShapeGroup>();
+    nested_plain->add(make_unique<Text>(900, 900, "not indexed"));
+
+    SpatialShapeGroup scene;
+    scene.add(move(nested_spatial));
+    scene.add(move(nested_plain));
+
+    REQUIRE(rendered(scene, Rect {0, 0, 10, 10}) == "Rendering text 'visible' at: [5, 5]\n"
+                                                    "Rendering text 'not indexed' at: [900, 900]\n");
+}
+
+TEST_CASE("SpatialShapeGroup - cell size must be positive")
+{
+    REQUIRE_THROWS_AS(SpatialShapeGroup {0}, std::invalid_argument);
+    REQUIRE_THROWS_AS(SpatialShapeGroup {-16}, std::invalid_argument);
+    REQUIRE(SpatialShapeGroup {1}.cell_size() == 1);
+}
@@ -0,0 +1,166 @@
+#ifndef STATIC_SHAPE_GROUP_HPP_
+#define STATIC_SHAPE_GROUP_HPP_
+
+#include "paragraph.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Group of shapes from a closed set of types
+// - every type is kept by value in its own contiguous array
+// - render() uses static dispatch and draws type after type, each in insertion order
+// - references returned by add() and emplace() are valid only until the next add(), emplace() or reserve()
+//   of the same type - use reserve() up front or keep the index of the shape in shapes_of<TShape>()
+// - changes of children mark the whole group dirty; render_incremental() then renders all of them
+template <typename... TShapes>
+class StaticShapeGroup : public Shape
+{
+    static_assert(std::conjunction_v<std::is_base_of<Shape, TShapes>...>, "StaticShapeGroup holds only shapes");
+
+    std::tuple<std::vector<TShapes>...> shapes_;
+
+    template <typename TShape>
+    static void render_all(const std::vector<TShape>& shapes, RenderBuffer& frame)
+    {
+        for (const auto& s : shapes)
+            s.TShape::render(frame); // qualified call - no virtual dispatch
+    }
+
+    template <typename TFunction>
+    void for_each_child(TFunction f)
+    {
+        std::apply([&f](auto&... shapes) { (std::for_each(shapes.begin(), shapes.end(), f), ...); }, shapes_);
+    }
+
+    // copies and moves of shapes (also by a growing vector) do not belong to any group
+    void adopt_children() noexcept
+    {
+        for_each_child([this](Shape& s) { adopt(s); });
+    }
+
+    template <typename TShape>
+    void adopt_children_of(std::vector<TShape>& shapes, const TShape* old_data) noexcept
+    {
+        if (shapes.data() != old_data)
+        {
+            for (auto& s : shapes)
+                adopt(s);
+        }
+        else
+        {
+            adopt(shapes.back());
+        }
+    }
+
+public:
+    StaticShapeGroup() = default;
+
+    StaticShapeGroup(const StaticShapeGroup& other)
+        : Shape(other)
+        , shapes_ {other.shapes_}
+    {
+        adopt_children();
+    }
+
+    StaticShapeGroup& operator=(const StaticShapeGroup& other)
+    {
+        if (this != &other)
+        {
+            shapes_ = other.shapes_;
+            adopt_children();
+            mark_dirty();
+        }
+        return *this;
+    }
+
+    StaticShapeGroup(StaticShapeGroup&& other) noexcept
+        : Shape(other)
+        , shapes_ {std::move(other.shapes_)}
+    {
+        adopt_children();
+        other.bump_revision();
+    }
+
+    StaticShapeGroup& operator=(StaticShapeGroup&& other) noexcept
+    {
+        if (this != &other)
+        {
+            shapes_ = std::move(other.shapes_);
+            adopt_children();
+            mark_dirty();
+            other.bump_revision();
+        }
+        return *this;
+    }
+
+    template <typename TShape>
+    TShape& add(TShape shape)
+    {
+        return emplace<TShape>(std::move(shape));
+    }
+
+    template <typename TShape, typename... TArgs>
+    TShape& emplace(TArgs&&... args)
+    {
+        auto& shapes = std::get<std::vector<TShape>>(shapes_);
+        const TShape* old_data = shapes.data();
+
+        shapes.emplace_back(std::forward<TArgs>(args)...);
+        adopt_children_of(shapes, old_data);
+        mark_dirty();
+
+        return shapes.back();
+    }
+
+    template <typename TShape>
+    const std::vector<TShape>& shapes_of() const noexcept
+    {
+        return std::get<std::vector<TShape>>(shapes_);
+    }
+
+    template <typename TShape>
+    void reserve(size_t count)
+    {
+        auto& shapes = std::get<std::vector<TShape>>(shapes_);
+        const TShape* old_data = shapes.data();
+
+        shapes.reserve(count);
+        if (shapes.data() != old_data)
+        {
+            for (auto& s : shapes)
+                adopt(s);
+        }
+    }
+
+    size_t size() const noexcept
+    {
+        return std::apply([](const auto&... shapes) { return (shapes.size() + ... + 0); }, shapes_);
+    }
+
+    void render(RenderBuffer& frame) const override
+    {
+        std::apply([&frame](const auto&... shapes) { (render_all(shapes, frame), ...); }, shapes_);
+    }
+
+    bool visit_children(const std::function<void(const Shape&)>& visitor) const override
+    {
+        std::apply([&visitor](const auto&... shapes) { (std::for_each(shapes.begin(), shapes.end(), visitor), ...); }, shapes_);
+        return true;
+    }
+
+    void render_incremental(RenderBuffer& frame) override
+    {
+        if (!is_dirty())
+            return;
+
+        render(frame);
+        for_each_child([](Shape& s) { mark_rendered(s); });
+        clear_dirty();
+    }
+};
+
+#endif /*STATIC_SHAPE_GROUP_HPP_*/
@@ -1,7 +1,10 @@
 #include "catch.hpp"
+#include "cow_paragraph.hpp"
 #include "paragraph.hpp"
+#include "static_shape_group.hpp"
 #include <iostream>
 #include <memory>
+#include <sstream>
 
 using namespace std;
 
@@ -28,8 +31,232 @@ TEST_CASE("ShapeGroup")
     ShapeGroup sg;
     sg.add(std::make_unique<Text>(10, 20, "text")); // uncomment this line
 
-    REQUIRE(sg.shapes.size() == 1);
+    REQUIRE(sg.shapes().size() == 1);
 
-    Text& t = dynamic_cast<Text&>(*sg.shapes[0]);
+    Text& t = dynamic_cast<Text&>(*sg.shapes()[0]);
     REQUIRE(t.text() == "text"s);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Paragraph - short and long texts")
+{
+    const std::string long_text(2000, 'x');
+
+    SECTION("default text")
+    {
+        LegacyCode::Paragraph p;
+
+        REQUIRE(p.get_paragraph() == string("Default text!"));
+        REQUIRE(p.length() == 13);
+    }
+
+    SECTION("long text is not truncated")
+    {
+        LegacyCode::Paragraph p(long_text.c_str());
+
+        REQUIRE(p.get_paragraph() == long_text);
+        REQUIRE(p.length() == long_text.size());
+    }
+
+    SECTION("copy keeps independent buffers")
+    {
+        LegacyCode::Paragraph p1("abc");
+        LegacyCode::Paragraph p2(long_text.c_str());
+
+        LegacyCode::Paragraph cp1 = p1;
+        LegacyCode::Paragraph cp2 = p2;
+        cp1.set_paragraph("def");
+        cp2.set_paragraph("short");
+
+        REQUIRE(p1.get_paragraph() == string("abc"));
+        REQUIRE(cp1.get_paragraph() == string("def"));
+        REQUIRE(p2.get_paragraph() == long_text);
+        REQUIRE(cp2.get_paragraph() == string("short"));
+    }
+
+    SECTION("set_paragraph grows and shrinks")
+    {
+        LegacyCode::Paragraph p("abc");
+
+        p.set_paragraph(long_text.c_str());
+        REQUIRE(p.get_paragraph() == long_text);
+
+        p.set_paragraph("abc");
+        REQUIRE(p.get_paragraph() == string("abc"));
+        REQUIRE(p.length() == 3);
+    }
+
+    SECTION("moving long and short texts")
+    {
+        LegacyCode::Paragraph p1("abc");
+        LegacyCode::Paragraph p2(long_text.c_str());
+
+        p1 = move(p2);
+
+        REQUIRE(p1.get_paragraph() == long_text);
+        REQUIRE(p2.get_paragraph() == nullptr);
+
+        p2.set_paragraph("reused");
+        REQUIRE(p2.get_paragraph() == string("reused"));
+    }
+}
+
+TEST_CASE("Paragraph - empty text")
+{
+    LegacyCode::Paragraph p("");
+
+    REQUIRE(p.get_paragraph() == string());
+    REQUIRE(p.length() == 0);
+
+    Text t {1, 2, ""};
+    REQUIRE(t.text() == ""s);
+}
+
+TEST_CASE("StaticShapeGroup")
+{
+    StaticShapeGroup<Text, CowText> sg;
+    sg.add(Text{10, 20, "text"});
+    sg.emplace<CowText>(30, 40, "cow text");
+
+    REQUIRE(sg.size() == 2);
+    REQUIRE(sg.shapes_of<CowText>()[0].text() == "cow text"s);
+
+    ShapeGroup scene;
+    scene.add(std::make_unique<StaticShapeGroup<Text, CowText>>(std::move(sg)));
+
+    ostringstream out;
+    auto* old_buffer = cout.rdbuf(out.rdbuf());
+    scene.draw();
+    cout.rdbuf(old_buffer);
+
+    REQUIRE(out.str() == "Rendering text 'text' at: [10, 20]\nRendering text 'cow text' at: [30, 40]\n");
+}
+
+TEST_CASE("ShapeGroup - incremental draw renders only changed shapes")
+{
+    ShapeGroup scene;
+    auto nested = std::make_unique<ShapeGroup>();
+    nested->add(std::make_unique<Text>(1, 1, "nested"));
+    Text& nested_txt = dynamic_cast<Text&>(*nested->shapes().back());
+    scene.add(std::move(nested));
+
+    std::vector<Text*> texts;
+    for (int i = 0; i < 100; ++i)
+    {
+        scene.add(std::make_unique<Text>(i, i, "label"));
+        texts.push_back(&dynamic_cast<Text&>(*scene.shapes().back()));
+    }
+
+    SECTION("first incremental draw renders everything")
+    {
+        RenderBuffer full, incremental;
+        scene.render(full);
+        scene.render_incremental(incremental);
+
+        REQUIRE(incremental.str() == full.str());
+        REQUIRE_FALSE(scene.is_dirty());
+    }
+
+    SECTION("later draws render only changes")
+    {
+        RenderBuffer frame;
+        scene.render_incremental(frame);
+        frame.clear();
+
+        scene.render_incremental(frame);
+        REQUIRE(frame.empty());
+
+        texts[42]->set_text("changed");
+        texts[7]->move_to(70, 70);
+        texts[42]->move_to(0, 0);
+        nested_txt.set_text("nested changed");
+        REQUIRE(scene.is_dirty());
+
+        scene.render_incremental(frame);
+        REQUIRE(frame.str() == "Rendering text 'changed' at: [0, 0]\n"
+                               "Rendering text 'label' at: [70, 70]\n"
+                               "Rendering text 'nested changed' at: [1, 1]\n");
+        REQUIRE_FALSE(scene.is_dirty());
+        REQUIRE_FALSE(texts[42]->is_dirty());
+    }
+
+    SECTION("moved group keeps tracking its children")
+    {
+        RenderBuffer frame;
+        scene.render_incremental(frame);
+        frame.clear();
+
+        ShapeGroup moved = std::move(scene);
+        texts[0]->set_text("after move");
+
+        moved.render_incremental(frame);
+        REQUIRE(frame.str() == "Rendering text 'after move' at: [0, 0]\n");
+    }
+}
+
+TEST_CASE("ShapeGroup - clear drops pending changes of the children")
+{
+    ShapeGroup scene;
+    scene.add(std::make_unique<Text>(1, 2, "text"));
+    scene.add(std::make_unique<Text>(3, 4, "other"));
+
+    RenderBuffer frame;
+    scene.render_incremental(frame);
+
+    dynamic_cast<Text&>(*scene.shapes()[1]).set_text("changed");
+    REQUIRE(scene.is_dirty());
+
+    const auto revision = scene.revision();
+    scene.clear();
+    REQUIRE(scene.shapes().empty());
+    REQUIRE(scene.revision() > revision);
+
+    ostringstream out;
+    auto* old_buffer = cout.rdbuf(out.rdbuf());
+    scene.draw_incremental();
+    cout.rdbuf(old_buffer);
+
+    REQUIRE(out.str().empty());
+
+    scene.add(std::make_unique<Text>(5, 6, "added"));
+    frame.clear();
+    scene.render_incremental(frame);
+    REQUIRE(frame.str() == "Rendering text 'added' at: [5, 6]\n");
+}
+
+TEST_CASE("StaticShapeGroup - changes of children reach enclosing groups")
+{
+    ShapeGroup scene;
+    auto group = std::make_unique<StaticShapeGroup<Text, CowText>>();
+    group->reserve<Text>(2);
+    Text& txt = group->emplace<Text>(1, 2, "text");
+    group->emplace<Text>(3, 4, "other");
+    auto& static_group = *group;
+    scene.add(std::move(group));
+
+    RenderBuffer frame;
+    scene.render_incremental(frame);
+    frame.clear();
+
+    const auto revision = scene.revision();
+    txt.set_text("changed");
+    REQUIRE(scene.revision() > revision);
+    REQUIRE(scene.is_dirty());
+
+    scene.render_incremental(frame);
+    REQUIRE(frame.str() == "Rendering text 'changed' at: [1, 2]\nRendering text 'other' at: [3, 4]\n");
+    frame.clear();
+
+    static_group.emplace<CowText>(5, 6, "cow"); // Text vector does not grow - txt stays valid
+    txt.set_text("changed again");
+    scene.render_incremental(frame);
+    REQUIRE(frame.str() == "Rendering text 'changed again' at: [1, 2]\nRendering text 'other' at: [3, 4]\n"
+                           "Rendering text 'cow' at: [5, 6]\n");
+    frame.clear();
+
+    StaticShapeGroup<Text, CowText> moved = std::move(static_group);
+    moved.render_incremental(frame);
+    frame.clear();
+
+    txt.set_text("after move");
+    REQUIRE(moved.is_dirty());
+}
@@ -0,0 +1,338 @@
+#ifndef TEXT_POOL_HPP_
+#define TEXT_POOL_HPP_
+
+#include "paragraph.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace LegacyCode
+{
+    class TextPool;
+
+    namespace Detail
+    {
+        struct TextPoolShard;
+
+        struct TextPoolEntry
+        {
+            std::string text;
+            size_t hash;
+            std::atomic<size_t> refs {0};
+            TextPoolShard* shard;
+
+            TextPoolEntry(std::string_view txt, size_t txt_hash, TextPoolShard* owner)
+                : text(txt)
+                , hash {txt_hash}
+                , shard {owner}
+            {
+            }
+        };
+
+        // text with its hash - the hash is computed once per lookup and used both for the shard and the index
+        struct TextPoolKey
+        {
+            std::string_view text;
+            size_t hash;
+
+            friend bool operator==(const TextPoolKey& lhs, const TextPoolKey& rhs) noexcept
+            {
+                return lhs.text == rhs.text;
+            }
+        };
+
+        struct TextPoolKeyHash
+        {
+            size_t operator()(const TextPoolKey& key) const noexcept
+            {
+                return key.hash;
+            }
+        };
+
+        struct TextPoolShard
+        {
+            mutable std::shared_mutex mtx;
+            std::unordered_map<TextPoolKey, std::unique_ptr<TextPoolEntry>, TextPoolKeyHash> index;
+        };
+    }
+
+    // counted reference to an interned, immutable text - equal texts from one pool have equal handles
+    // - the text is removed from the pool when its last handle is destroyed
+    class TextHandle
+    {
+        Detail::TextPoolEntry* entry_ = nullptr;
+
+        friend class TextPool;
+
+        // entry must already have its count incremented for this handle
+        explicit TextHandle(Detail::TextPoolEntry* entry) noexcept
+            : entry_ {entry}
+        {
+        }
+
+        static void release(Detail::TextPoolEntry* entry) noexcept;
+
+    public:
+        TextHandle() = default;
+
+        TextHandle(const TextHandle& other) noexcept
+            : entry_ {other.entry_}
+        {
+            if (entry_)
+                entry_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        TextHandle& operator=(const TextHandle& other) noexcept
+        {
+            TextHandle temp(other);
+            std::swap(entry_, temp.entry_);
+
+            return *this;
+        }
+
+        TextHandle(TextHandle&& other) noexcept
+            : entry_ {std::exchange(other.entry_, nullptr)}
+        {
+        }
+
+        TextHandle& operator=(TextHandle&& other) noexcept
+        {
+            TextHandle temp(std::move(other));
+            std::swap(entry_, temp.entry_);
+
+            return *this;
+        }
+
+        ~TextHandle()
+        {
+            if (entry_)
+                release(entry_);
+        }
+
+        const char* c_str() const noexcept
+        {
+            return entry_ ? entry_->text.c_str() : nullptr;
+        }
+
+        size_t size() const noexcept
+        {
+            return entry_ ? entry_->text.size() : 0;
+        }
+
+        std::string_view view() const noexcept
+        {
+            return entry_ ? std::string_view(entry_->text) : std::string_view();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return entry_ != nullptr;
+        }
+
+        friend bool operator==(const TextHandle& lhs, const TextHandle& rhs) noexcept
+        {
+            return lhs.entry_ == rhs.entry_;
+        }
+
+        friend bool operator!=(const TextHandle& lhs, const TextHandle& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    // Stores every distinct text once; lookups and inserts may run concurrently
+    // - a text lives as long as any handle to it - the pool must outlive all its handles
+    class TextPool
+    {
+        static constexpr size_t shard_count = 16;
+
+        using Shard = Detail::TextPoolShard;
+        using Key = Detail::TextPoolKey;
+
+        std::array<Shard, shard_count> shards_;
+
+        static Key key_for(std::string_view text) noexcept
+        {
+            return Key {text, std::hash<std::string_view> {}(text)};
+        }
+
+        Shard& shard_for(const Key& key)
+        {
+            return shards_[key.hash % shard_count];
+        }
+
+        const Shard& shard_for(const Key& key) const
+        {
+            return shards_[key.hash % shard_count];
+        }
+
+        // handle to an entry found in the index; must be called with the shard's mutex locked
+        static TextHandle acquire(Detail::TextPoolEntry& entry) noexcept
+        {
+            entry.refs.fetch_add(1, std::memory_order_relaxed);
+            return TextHandle {&entry};
+        }
+
+        friend class TextHandle;
+
+    public:
+        TextPool() = default;
+        TextPool(const TextPool&) = delete;
+        TextPool& operator=(const TextPool&) = delete;
+
+        // intentionally never destroyed - handles may outlive static objects
+        static TextPool& global()
+        {
+            static TextPool* pool = new TextPool();
+            return *pool;
+        }
+
+        TextHandle intern(std::string_view text)
+        {
+            const Key key = key_for(text);
+            Shard& shard = shard_for(key);
+
+            {
+                std::shared_lock<std::shared_mutex> lk {shard.mtx};
+                auto pos = shard.index.find(key);
+                if (pos != shard.index.end())
+                    return acquire(*pos->second);
+            }
+
+            std::unique_lock<std::shared_mutex> lk {shard.mtx};
+            auto pos = shard.index.find(key); // another thread could insert it in the meantime
+            if (pos != shard.index.end())
+                return acquire(*pos->second);
+
+            auto entry = std::make_unique<Detail::TextPoolEntry>(text, key.hash, &shard);
+            Detail::TextPoolEntry& inserted = *entry;
+            shard.index.emplace(Key {inserted.text, key.hash}, std::move(entry));
+
+            return acquire(inserted);
+        }
+
+        // returns an empty handle when the text is not in the pool
+        TextHandle find(std::string_view text) const
+        {
+            const Key key = key_for(text);
+            const Shard& shard = shard_for(key);
+
+            std::shared_lock<std::shared_mutex> lk {shard.mtx};
+            auto pos = shard.index.find(key);
+
+            return (pos != shard.index.end()) ? acquire(*pos->second) : TextHandle {};
+        }
+
+        size_t size() const
+        {
+            size_t result = 0;
+            for (const Shard& shard : shards_)
+            {
+                std::shared_lock<std::shared_mutex> lk {shard.mtx};
+                result += shard.index.size();
+            }
+
+            return result;
+        }
+    };
+
+    inline void TextHandle::release(Detail::TextPoolEntry* entry) noexcept
+    {
+        // counts above 1 drop without the lock; the last one drops under the exclusive lock,
+        // so no intern() can pick the entry up while it is being removed
+        size_t refs = entry->refs.load(std::memory_order_relaxed);
+        while (refs > 1)
+        {
+            if (entry->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel))
+                return;
+        }
+
+        Detail::TextPoolShard& shard = *entry->shard;
+        std::unique_lock<std::shared_mutex> lk {shard.mtx};
+
+        if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            shard.index.erase(Detail::TextPoolKey {entry->text, entry->hash});
+    }
+
+    // Paragraph that keeps only a handle to a text interned in the global TextPool
+    // - the text leaves the pool together with the last paragraph that uses it
+    class InternedParagraph
+    {
+        TextHandle handle_;
+
+    public:
+        InternedParagraph()
+            : InternedParagraph("Default text!")
+        {
+        }
+
+        InternedParagraph(const char* txt)
+            : InternedParagraph(txt, std::strlen(txt))
+        {
+        }
+
+        InternedParagraph(const char* txt, size_t length)
+            : handle_ {TextPool::global().intern(std::string_view(txt, length))}
+        {
+        }
+
+        InternedParagraph(const InternedParagraph&) = default;
+        InternedParagraph& operator=(const InternedParagraph&) = default;
+
+        InternedParagraph(InternedParagraph&& other) noexcept = default;
+        InternedParagraph& operator=(InternedParagraph&& other) noexcept = default;
+
+        void set_paragraph(const char* txt)
+        {
+            set_paragraph(txt, std::strlen(txt));
+        }
+
+        void set_paragraph(const char* txt, size_t length)
+        {
+            handle_ = TextPool::global().intern(std::string_view(txt, length));
+        }
+
+        const char* get_paragraph() const noexcept
+        {
+            return handle_.c_str();
+        }
+
+        size_t length() const noexcept
+        {
+            return handle_.size();
+        }
+
+        const TextHandle& handle() const noexcept
+        {
+            return handle_;
+        }
+
+        void render_at(RenderBuffer& frame, int posx, int posy) const
+        {
+            frame.render_text(std::string_view(get_paragraph() ? get_paragraph() : "", length()), posx, posy);
+        }
+
+        friend bool operator==(const InternedParagraph& lhs, const InternedParagraph& rhs) noexcept
+        {
+            return lhs.handle_ == rhs.handle_;
+        }
+
+        friend bool operator!=(const InternedParagraph& lhs, const InternedParagraph& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+}
+
+using InternedText = BasicText<LegacyCode::InternedParagraph>;
+
+#endif /*TEXT_POOL_HPP_*/
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "text_pool.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST_CASE("TextPool - equal texts share one entry")
+{
+    LegacyCode::TextPool pool;
+
+    auto h1 = pool.intern("label");
+    auto h2 = pool.intern(string("lab") + "el");
+    auto h3 = pool.intern("other");
+
+    REQUIRE(h1 == h2);
+    REQUIRE(h1.c_str() == h2.c_str());
+    REQUIRE(h1 != h3);
+    REQUIRE(pool.size() == 2);
+
+    REQUIRE(pool.find("other") == h3);
+    REQUIRE_FALSE(pool.find("missing"));
+}
+
+TEST_CASE("TextPool - text is removed with its last handle")
+{
+    LegacyCode::TextPool pool;
+
+    auto h1 = pool.intern("temporary");
+    auto h2 = h1;
+    REQUIRE(pool.size() == 1);
+
+    h1 = LegacyCode::TextHandle {};
+    REQUIRE(pool.size() == 1);
+    REQUIRE(h2.view() == "temporary");
+
+    h2 = pool.intern("another");
+    REQUIRE(pool.size() == 1);
+    REQUIRE_FALSE(pool.find("temporary"));
+
+    {
+        InternedText t1 {0, 0, "scoped label"};
+        InternedText t2 = t1;
+        REQUIRE(LegacyCode::TextPool::global().find("scoped label"));
+    }
+
+    REQUIRE_FALSE(LegacyCode::TextPool::global().find("scoped label"));
+}
+
+TEST_CASE("InternedText - texts are shared and compared by handle")
+{
+    InternedText t1 {1, 2, "repeated label"};
+    InternedText t2 {3, 4, "repeated label"};
+
+    REQUIRE(t1.paragraph() == t2.paragraph());
+    REQUIRE(t1.text_view().data() == t2.text_view().data());
+    REQUIRE(t1.text_view() == "repeated label");
+
+    t2.set_text("changed");
+    REQUIRE(t1.paragraph() != t2.paragraph());
+    REQUIRE(t1.text() == "repeated label"s);
+
+    InternedText mt = move(t1);
+    REQUIRE(t1.text() == string());
+    REQUIRE(mt.text_view() == "repeated label");
+}
+
+TEST_CASE("TextPool - concurrent loaders")
+{
+    LegacyCode::TextPool pool;
+    vector<vector<LegacyCode::TextHandle>> handles(4);
+
+    vector<thread> threads;
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        threads.emplace_back([&pool, &result = handles[i]] {
+            for (int j = 0; j < 1000; ++j)
+                result.push_back(pool.intern("label-" + to_string(j % 100)));
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(pool.size() == 100);
+    for (const auto& result : handles)
+        REQUIRE(result == handles.front());
+}
+
+TEST_CASE("TextPool - concurrent intern and release")
+{
+    LegacyCode::TextPool pool;
+
+    vector<thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&pool] {
+            for (int j = 0; j < 10'000; ++j)
+            {
+                auto handle = pool.intern("label-" + to_string(j % 10));
+                auto copy = handle;
+            }
+        });
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(pool.size() == 0);
+}
@@ -0,0 +1,74 @@
+#include "../relocating_vector.hpp"
+#include "../unique_ptr.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// cost of growing a container of handles: RelocatingVector (realloc) vs std::vector (move + destroy per element)
+// elements are created before the clock starts and moved into the container - only push_back is timed
+
+namespace
+{
+    template <typename TContainer, typename TFactory>
+    double measure_push_back(size_t count, TFactory make, bool reserve, int repetitions = 5)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            std::vector<decltype(make(0))> source;
+            source.reserve(count);
+            for (size_t n = 0; n < count; ++n)
+                source.push_back(make(n));
+
+            TContainer container;
+            if (reserve)
+                container.reserve(count);
+
+            const auto start = Bench::Clock::now();
+            for (auto& item : source)
+                container.push_back(std::move(item));
+            const auto stop = Bench::Clock::now();
+            Bench::do_not_optimize(container);
+
+            const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+            best = (i == 0) ? elapsed : std::min(best, elapsed);
+        }
+
+        return best;
+    }
+
+    template <typename T, typename TFactory>
+    void run(const std::string& kind, TFactory make)
+    {
+        for (size_t count : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20, size_t(1) << 22})
+        {
+            const std::string suffix = " - " + kind + ", " + std::to_string(count);
+
+            const double vector_ns = measure_push_back<std::vector<T>>(count, make, false);
+            const double relocating_ns = measure_push_back<RelocatingVector<T>>(count, make, false);
+            const double reserved_ns = measure_push_back<std::vector<T>>(count, make, true);
+
+            Bench::report("std::vector" + suffix, vector_ns, count);
+            Bench::report("RelocatingVector" + suffix, relocating_ns, count);
+            Bench::report("std::vector (reserved)" + suffix, reserved_ns, count);
+
+            // growth cost - time above the push_back into reserved storage
+            std::cout << "    growth: std::vector " << std::max(0.0, vector_ns - reserved_ns) / count << " ns/elem, RelocatingVector "
+                      << std::max(0.0, relocating_ns - reserved_ns) / count << " ns/elem\n";
+        }
+    }
+}
+
+int main()
+{
+    static_assert(IsTriviallyRelocatable<UniquePtr<int>>::value, "relocated with realloc");
+    static_assert(IsTriviallyRelocatable<std::shared_ptr<int>>::value, "relocated with realloc");
+
+    run<UniquePtr<int>>("UniquePtr<int>", [](size_t i) { return MakeUnique<int>(static_cast<int>(i)); });
+    run<std::shared_ptr<int>>("shared_ptr<int>", [](size_t i) { return std::make_shared<int>(static_cast<int>(i)); });
+}
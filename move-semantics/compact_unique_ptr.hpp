@@ -0,0 +1,444 @@
+#ifndef COMPACT_UNIQUE_PTR_HPP
+#define COMPACT_UNIQUE_PTR_HPP
+
+#include "trivially_relocatable.hpp"
+#include "unique_ptr.hpp"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace Detail
+{
+    // number of low bits that are always zero in addresses aligned to alignment
+    constexpr unsigned alignment_bits(size_t alignment)
+    {
+        unsigned bits = 0;
+        while (alignment > 1)
+        {
+            alignment /= 2;
+            ++bits;
+        }
+
+        return bits;
+    }
+
+    // ArenaUniquePtr<T> owns U* only when U is T - the block size and the destructor are taken from T
+    template <typename U, typename T>
+    using EnableIfSameType = std::enable_if_t<std::is_same<U, T>::value>;
+}
+
+////////////////////////////////////////////////////////////////////
+// UniquePtr that keeps a small tag (type tag, state bits) in the alignment bits of the pointer
+// - sizeof(TaggedUniquePtr<T, TagBits>) == sizeof(T*) for stateless deleters
+// - TagBits must fit in the alignment of T (checked where T is complete, so T may be the enclosing node type)
+// - the tag belongs to the pointer: it is moved with the object and kept by reset() and release()
+template <typename T, unsigned TagBits, typename TDeleter = DefaultDelete<T>>
+class TaggedUniquePtr : private Detail::CompressedStorage<TDeleter>
+{
+    static_assert(TagBits > 0, "no bits for a tag");
+
+    using DeleterStorage = Detail::CompressedStorage<TDeleter>;
+
+    static constexpr std::uintptr_t tag_mask = (std::uintptr_t(1) << TagBits) - 1;
+
+    std::uintptr_t bits_;
+
+    static std::uintptr_t pack(T* ptr, unsigned tag) noexcept
+    {
+        static_assert(TagBits <= Detail::alignment_bits(alignof(T)), "tag does not fit in the alignment bits of T*");
+        assert(tag <= tag_mask);
+        return reinterpret_cast<std::uintptr_t>(ptr) | tag;
+    }
+
+public:
+    using element_type = T;
+    using deleter_type = TDeleter;
+
+    static constexpr unsigned max_tag = static_cast<unsigned>(tag_mask);
+
+    TaggedUniquePtr() noexcept
+        : bits_ {0}
+    {
+    }
+
+    TaggedUniquePtr(std::nullptr_t) noexcept
+        : bits_ {0}
+    {
+    }
+
+    explicit TaggedUniquePtr(T* ptr, unsigned tag = 0) noexcept
+        : bits_ {pack(ptr, tag)}
+    {
+    }
+
+    TaggedUniquePtr(T* ptr, unsigned tag, const TDeleter& deleter) noexcept
+        : DeleterStorage(deleter)
+        , bits_ {pack(ptr, tag)}
+    {
+    }
+
+    // takes over the object of a UniquePtr
+    explicit TaggedUniquePtr(UniquePtr<T, TDeleter>&& source, unsigned tag = 0) noexcept
+        : DeleterStorage(std::move(source.get_deleter()))
+        , bits_ {pack(source.release(), tag)}
+    {
+    }
+
+    TaggedUniquePtr(const TaggedUniquePtr&) = delete;
+    TaggedUniquePtr& operator=(const TaggedUniquePtr&) = delete;
+
+    TaggedUniquePtr(TaggedUniquePtr&& source) noexcept
+        : DeleterStorage(std::move(source.get_deleter()))
+        , bits_ {std::exchange(source.bits_, 0)}
+    {
+    }
+
+    TaggedUniquePtr& operator=(TaggedUniquePtr&& source) noexcept
+    {
+        if (this != &source)
+        {
+            reset();
+            bits_ = std::exchange(source.bits_, 0);
+            get_deleter() = std::move(source.get_deleter());
+        }
+
+        return *this;
+    }
+
+    ~TaggedUniquePtr() noexcept
+    {
+        if (T* ptr = get())
+            get_deleter()(ptr);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return get() != nullptr;
+    }
+
+    T* get() const noexcept
+    {
+        return reinterpret_cast<T*>(bits_ & ~tag_mask);
+    }
+
+    T* operator->() const noexcept
+    {
+        return get();
+    }
+
+    T& operator*() const noexcept
+    {
+        return *get();
+    }
+
+    unsigned tag() const noexcept
+    {
+        return static_cast<unsigned>(bits_ & tag_mask);
+    }
+
+    void set_tag(unsigned tag) noexcept
+    {
+        bits_ = pack(get(), tag);
+    }
+
+    TDeleter& get_deleter() noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    const TDeleter& get_deleter() const noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    T* release() noexcept
+    {
+        T* ptr = get();
+        bits_ &= tag_mask;
+
+        return ptr;
+    }
+
+    void reset(T* ptr = nullptr) noexcept
+    {
+        T* old_ptr = get();
+        bits_ = pack(ptr, tag());
+
+        if (old_ptr)
+            get_deleter()(old_ptr);
+    }
+
+    void swap(TaggedUniquePtr& other) noexcept
+    {
+        using std::swap;
+        swap(bits_, other.bits_);
+        swap(get_deleter(), other.get_deleter());
+    }
+};
+
+template <typename T, unsigned TagBits, typename TDeleter>
+struct IsTriviallyRelocatable<TaggedUniquePtr<T, TagBits, TDeleter>> : IsTriviallyRelocatable<TDeleter>
+{
+};
+
+////////////////////////////////////////////////////////////////////
+// Memory block of up to 4 GiB addressed with 32-bit offsets
+// - offset 0 is never allocated - it stands for nullptr
+// - blocks are rounded up to alignof(std::max_align_t) (empty ones too); freed blocks go to a free list
+//   for their size and are reused by the next allocation of the same size
+// - free lists of small blocks are found by index, lists of bigger blocks are kept in a hash map
+class Arena
+{
+public:
+    using Offset = std::uint32_t;
+
+    static constexpr size_t granularity = alignof(std::max_align_t);
+
+private:
+    UniquePtr<unsigned char[]> storage_;
+    size_t capacity_;
+    size_t used_ = granularity;
+
+    static constexpr size_t small_list_count = 65; // blocks of up to 64 granules
+
+    // heads of the free lists - next offsets are stored in the free blocks
+    std::array<Offset, small_list_count> small_free_lists_ {}; // index: size / granularity
+    std::unordered_map<size_t, Offset> large_free_lists_; // key: block size
+
+    // list for blocks of the given size - allocate() creates it, so deallocate() never allocates
+    Offset& free_list(size_t block)
+    {
+        const size_t index = block / granularity;
+        if (index < small_free_lists_.size())
+            return small_free_lists_[index];
+
+        return large_free_lists_[block];
+    }
+
+    // every block has room for the free list link - blocks of size 0 would all share one offset
+    static size_t block_size(size_t size) noexcept
+    {
+        return size == 0 ? granularity : (size + granularity - 1) / granularity * granularity;
+    }
+
+    static size_t checked_capacity(size_t capacity)
+    {
+        if (capacity > size_t(std::numeric_limits<Offset>::max()) + 1)
+            throw std::length_error("Arena: capacity above 4 GiB cannot be addressed with 32-bit offsets");
+
+        return capacity;
+    }
+
+public:
+    explicit Arena(size_t capacity)
+        : storage_ {MakeUniqueForOverwrite<unsigned char[]>(checked_capacity(capacity))}
+        , capacity_ {capacity}
+    {
+    }
+
+    Offset allocate(size_t size)
+    {
+        if (size > capacity_)
+            throw std::bad_alloc {};
+
+        const size_t block = block_size(size);
+        Offset& head = free_list(block);
+
+        if (head != 0)
+        {
+            const Offset offset = head;
+            head = *reinterpret_cast<Offset*>(address(offset));
+
+            return offset;
+        }
+
+        if (used_ + block > capacity_)
+            throw std::bad_alloc {};
+
+        const Offset offset = static_cast<Offset>(used_);
+        used_ += block;
+
+        return offset;
+    }
+
+    void deallocate(Offset offset, size_t size) noexcept
+    {
+        Offset& head = free_list(block_size(size));
+
+        *reinterpret_cast<Offset*>(address(offset)) = head;
+        head = offset;
+    }
+
+    void* address(Offset offset) const noexcept
+    {
+        return storage_.get() + offset;
+    }
+
+    Offset offset_of(const void* ptr) const noexcept
+    {
+        assert(owns(ptr));
+        return static_cast<Offset>(static_cast<const unsigned char*>(ptr) - storage_.get());
+    }
+
+    bool owns(const void* ptr) const noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*>(ptr);
+        return bytes >= storage_.get() + granularity && bytes < storage_.get() + used_;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // bytes taken from the block so far (including freed blocks waiting for reuse)
+    size_t used() const noexcept
+    {
+        return used_;
+    }
+};
+
+////////////////////////////////////////////////////////////////////
+// UniquePtr stored as a 32-bit offset into an arena given as a template parameter
+// - sizeof(ArenaUniquePtr<T, arena>) == 4
+// - the object is destroyed and its block goes back to the arena
+// - the arena must outlive all its pointers
+template <typename T, Arena& TArena>
+class ArenaUniquePtr
+{
+    Arena::Offset offset_;
+
+public:
+    using element_type = T;
+
+    ArenaUniquePtr() noexcept
+        : offset_ {0}
+    {
+    }
+
+    ArenaUniquePtr(std::nullptr_t) noexcept
+        : offset_ {0}
+    {
+    }
+
+    // ptr must point to an object created in a block allocated from TArena
+    template <typename U, typename = Detail::EnableIfSameType<U, T>>
+    explicit ArenaUniquePtr(U* ptr) noexcept
+        : offset_ {ptr ? TArena.offset_of(ptr) : 0}
+    {
+    }
+
+    ArenaUniquePtr(const ArenaUniquePtr&) = delete;
+    ArenaUniquePtr& operator=(const ArenaUniquePtr&) = delete;
+
+    ArenaUniquePtr(ArenaUniquePtr&& source) noexcept
+        : offset_ {std::exchange(source.offset_, 0)}
+    {
+    }
+
+    ArenaUniquePtr& operator=(ArenaUniquePtr&& source) noexcept
+    {
+        if (this != &source)
+        {
+            reset();
+            offset_ = std::exchange(source.offset_, 0);
+        }
+
+        return *this;
+    }
+
+    ~ArenaUniquePtr() noexcept
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return offset_ != 0;
+    }
+
+    T* get() const noexcept
+    {
+        return offset_ ? static_cast<T*>(TArena.address(offset_)) : nullptr;
+    }
+
+    T* operator->() const noexcept
+    {
+        return get();
+    }
+
+    T& operator*() const noexcept
+    {
+        return *get();
+    }
+
+    Arena::Offset offset() const noexcept
+    {
+        return offset_;
+    }
+
+    // the block stays allocated in the arena
+    T* release() noexcept
+    {
+        T* ptr = get();
+        offset_ = 0;
+
+        return ptr;
+    }
+
+    void reset(std::nullptr_t = nullptr) noexcept
+    {
+        reset(static_cast<T*>(nullptr));
+    }
+
+    template <typename U, typename = Detail::EnableIfSameType<U, T>>
+    void reset(U* ptr) noexcept
+    {
+        T* old_ptr = get();
+        offset_ = ptr ? TArena.offset_of(ptr) : 0;
+
+        if (old_ptr)
+        {
+            const Arena::Offset old_offset = TArena.offset_of(old_ptr);
+            old_ptr->~T();
+            TArena.deallocate(old_offset, sizeof(T));
+        }
+    }
+
+    void swap(ArenaUniquePtr& other) noexcept
+    {
+        std::swap(offset_, other.offset_);
+    }
+};
+
+template <typename T, Arena& TArena>
+struct IsTriviallyRelocatable<ArenaUniquePtr<T, TArena>> : std::true_type
+{
+};
+
+template <typename T, Arena& TArena, typename... TArgs>
+ArenaUniquePtr<T, TArena> MakeArenaUnique(TArgs&&... args)
+{
+    static_assert(alignof(T) <= Arena::granularity, "arena blocks are not aligned enough for T");
+
+    const Arena::Offset offset = TArena.allocate(sizeof(T));
+
+    try
+    {
+        return ArenaUniquePtr<T, TArena>{new (TArena.address(offset)) T(std::forward<TArgs>(args)...)};
+    }
+    catch (...)
+    {
+        TArena.deallocate(offset, sizeof(T));
+        throw;
+    }
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "catch.hpp"
+#include "compact_unique_ptr.hpp"
+#include "gadget.hpp"
+#include "relocating_vector.hpp"
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    enum class Color : unsigned
+    {
+        red,
+        black
+    };
+
+    // red-black tree node - the color lives in the pointers' alignment bits
+    struct TreeNode
+    {
+        int key;
+        TaggedUniquePtr<TreeNode, 1> left;
+        TaggedUniquePtr<TreeNode, 1> right;
+
+        explicit TreeNode(int k)
+            : key {k}
+        {
+        }
+    };
+
+    Arena node_arena {1 << 20};
+
+    struct ListNode
+    {
+        int value;
+        ArenaUniquePtr<ListNode, node_arena> next;
+
+        static int alive;
+
+        explicit ListNode(int v)
+            : value {v}
+        {
+            ++alive;
+        }
+
+        ~ListNode()
+        {
+            --alive;
+        }
+    };
+
+    int ListNode::alive = 0;
+
+    struct DerivedListNode : ListNode
+    {
+        std::string label;
+
+        DerivedListNode()
+            : ListNode {0}
+        {
+        }
+    };
+
+    template <typename TPointer, typename U, typename = void>
+    struct CanReset : std::false_type
+    {
+    };
+
+    template <typename TPointer, typename U>
+    struct CanReset<TPointer, U, decltype(std::declval<TPointer&>().reset(std::declval<U>()))> : std::true_type
+    {
+    };
+
+    struct Throwing
+    {
+        Throwing()
+        {
+            throw std::runtime_error {"ctor"};
+        }
+    };
+
+    Arena small_arena {64};
+}
+
+TEST_CASE("TaggedUniquePtr")
+{
+    static_assert(sizeof(TaggedUniquePtr<TreeNode, 1>) == sizeof(TreeNode*), "tag takes no space");
+    static_assert(sizeof(TreeNode) == 3 * sizeof(void*), "two pointers with colors");
+    static_assert(IsTriviallyRelocatable<TaggedUniquePtr<Gadget, 3>>::value, "relocatable as UniquePtr");
+
+    SECTION("tag is stored next to the pointer")
+    {
+        TaggedUniquePtr<Gadget, 3> g {new Gadget {1, "ipad"}, 5};
+        const unsigned max_tag = TaggedUniquePtr<Gadget, 3>::max_tag;
+
+        REQUIRE(max_tag == 7);
+        REQUIRE(g.tag() == 5);
+        REQUIRE(g->id == 1);
+        REQUIRE((*g).name == "ipad");
+
+        g.set_tag(2);
+        REQUIRE(g.tag() == 2);
+        REQUIRE(g->name == "ipad");
+
+        g.reset(new Gadget {2, "smart-tv"});
+        REQUIRE(g.tag() == 2);
+        REQUIRE(g->id == 2);
+
+        g.reset();
+        REQUIRE(!g);
+        REQUIRE(g.tag() == 2);
+    }
+
+    SECTION("tag moves with the object")
+    {
+        TaggedUniquePtr<TreeNode, 1> root {new TreeNode {10}, static_cast<unsigned>(Color::black)};
+        root->left = TaggedUniquePtr<TreeNode, 1> {new TreeNode {5}, static_cast<unsigned>(Color::red)};
+        root->right = TaggedUniquePtr<TreeNode, 1> {MakeUnique<TreeNode>(15), static_cast<unsigned>(Color::red)};
+
+        TaggedUniquePtr<TreeNode, 1> moved = std::move(root);
+        REQUIRE(!root);
+        REQUIRE(root.tag() == 0);
+        REQUIRE(moved.tag() == static_cast<unsigned>(Color::black));
+        REQUIRE(moved->left.tag() == static_cast<unsigned>(Color::red));
+        REQUIRE(moved->right->key == 15);
+
+        TreeNode* raw = moved->left.release();
+        REQUIRE(moved->left.tag() == static_cast<unsigned>(Color::red));
+        delete raw;
+    }
+
+    SECTION("relocated by RelocatingVector")
+    {
+        RelocatingVector<TaggedUniquePtr<Gadget, 2>> gadgets;
+        for (int i = 0; i < 10; ++i)
+            gadgets.emplace_back(new Gadget {i}, static_cast<unsigned>(i % 4));
+
+        REQUIRE(gadgets[9]->id == 9);
+        REQUIRE(gadgets[9].tag() == 1);
+    }
+}
+
+TEST_CASE("ArenaUniquePtr")
+{
+    static_assert(sizeof(ArenaUniquePtr<ListNode, node_arena>) == sizeof(std::uint32_t), "32-bit offset");
+    static_assert(sizeof(ListNode) == 2 * sizeof(std::uint32_t), "two nodes in the space of one UniquePtr<Node> node");
+    static_assert(std::is_constructible<ArenaUniquePtr<ListNode, node_arena>, ListNode*>::value, "adopts ListNode*");
+    static_assert(!std::is_constructible<ArenaUniquePtr<ListNode, node_arena>, DerivedListNode*>::value,
+        "a derived object would be destroyed as ListNode and freed as a block of sizeof(ListNode)");
+    static_assert(CanReset<ArenaUniquePtr<ListNode, node_arena>, ListNode*>::value, "reset(ListNode*)");
+    static_assert(!CanReset<ArenaUniquePtr<ListNode, node_arena>, DerivedListNode*>::value, "no reset(DerivedListNode*)");
+
+    SECTION("ownership")
+    {
+        {
+            auto head = MakeArenaUnique<ListNode, node_arena>(1);
+            REQUIRE(node_arena.owns(head.get()));
+            REQUIRE(head.offset() != 0);
+
+            head->next = MakeArenaUnique<ListNode, node_arena>(2);
+            head->next->next = MakeArenaUnique<ListNode, node_arena>(3);
+            REQUIRE(ListNode::alive == 3);
+
+            auto second = std::move(head->next);
+            REQUIRE(!head->next);
+            REQUIRE(second->next->value == 3);
+
+            head = std::move(second);
+            REQUIRE(ListNode::alive == 2);
+            REQUIRE(head->value == 2);
+        }
+
+        REQUIRE(ListNode::alive == 0);
+    }
+
+    SECTION("freed blocks are reused")
+    {
+        const size_t used = node_arena.used();
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto node = MakeArenaUnique<ListNode, node_arena>(i);
+            REQUIRE(node->value == i);
+        }
+
+        REQUIRE(node_arena.used() <= used + Arena::granularity);
+    }
+
+    SECTION("release and adopt")
+    {
+        auto node = MakeArenaUnique<ListNode, node_arena>(7);
+        ListNode* raw = node.release();
+        REQUIRE(!node);
+
+        ArenaUniquePtr<ListNode, node_arena> adopted {raw};
+        REQUIRE(adopted->value == 7);
+    }
+
+    SECTION("full arena and throwing constructors")
+    {
+        auto a = MakeArenaUnique<int, small_arena>(1);
+        auto b = MakeArenaUnique<int, small_arena>(2);
+        auto c = MakeArenaUnique<int, small_arena>(3);
+
+        REQUIRE_THROWS_AS((MakeArenaUnique<int, small_arena>(4)), std::bad_alloc);
+
+        c.reset();
+        REQUIRE_THROWS_AS((MakeArenaUnique<Throwing, small_arena>()), std::runtime_error);
+
+        auto d = MakeArenaUnique<int, small_arena>(4); // block of the failed Throwing is back on the free list
+        REQUIRE(*d == 4);
+        REQUIRE(*a + *b == 3);
+    }
+}
+
+TEST_CASE("Arena")
+{
+    SECTION("capacity must be addressable with 32-bit offsets")
+    {
+        if (sizeof(size_t) > sizeof(std::uint32_t))
+            REQUIRE_THROWS_AS(Arena {size_t(std::numeric_limits<std::uint32_t>::max()) + 2}, std::length_error);
+    }
+
+    SECTION("empty blocks take one granule")
+    {
+        Arena arena {4 * Arena::granularity};
+
+        const Arena::Offset first = arena.allocate(0);
+        const Arena::Offset second = arena.allocate(0);
+        REQUIRE(first != second);
+        REQUIRE(arena.used() == 3 * Arena::granularity);
+
+        arena.deallocate(second, 0);
+        REQUIRE(arena.allocate(0) == second);
+        REQUIRE_THROWS_AS(arena.allocate(std::numeric_limits<size_t>::max()), std::bad_alloc);
+    }
+
+    SECTION("big blocks have their own free lists")
+    {
+        const size_t big = size_t(1) << 24;
+        Arena arena {3 * big};
+
+        const Arena::Offset first = arena.allocate(big);
+        const Arena::Offset second = arena.allocate(big + 1);
+        REQUIRE(arena.used() == Arena::granularity + 2 * big + Arena::granularity);
+
+        arena.deallocate(first, big);
+        arena.deallocate(second, big + 1);
+        REQUIRE(arena.allocate(big + 1) == second);
+        REQUIRE(arena.allocate(big) == first);
+        REQUIRE(arena.used() == Arena::granularity + 2 * big + Arena::granularity);
+    }
+}
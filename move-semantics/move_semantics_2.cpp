@@ -1,79 +1,9 @@
 #include "catch.hpp"
 #include "gadget.hpp"
+#include "unique_ptr.hpp"
 #include <memory>
 #include <string>
 
-template <typename T>
-class UniquePtr
-{
-    T* ptr_;
-
-public:
-    UniquePtr(nullptr_t) noexcept
-        : ptr_ {nullptr}
-    {
-    }
-
-    UniquePtr() noexcept
-        : ptr_ {nullptr}
-    {
-    }
-
-    explicit UniquePtr(T* ptr) noexcept
-        : ptr_ {ptr}
-    {
-    }
-
-    UniquePtr(const UniquePtr&) = delete;
-    UniquePtr& operator=(const UniquePtr&) = delete;
-
-    // move constructor
-    UniquePtr(UniquePtr&& source) noexcept
-        : ptr_ {source.ptr_}
-    {
-        source.ptr_ = nullptr;
-    }
-
-    // move assignment operator
-    UniquePtr& operator=(UniquePtr&& source) noexcept
-    {
-        if (this != &source)
-        {
-            delete ptr_; // deleting previous resource
-
-            ptr_ = source.ptr_;
-            source.ptr_ = nullptr;
-        }
-
-        return *this;
-    }
-
-    ~UniquePtr() noexcept
-    {
-        delete ptr_;
-    }
-
-    explicit operator bool() const noexcept
-    {
-        return ptr_ != nullptr;
-    }
-
-    T* get() const noexcept
-    {
-        return ptr_;
-    }
-
-    T* operator->() const noexcept
-    {
-        return ptr_;
-    }
-
-    T& operator*() const noexcept
-    {
-        return ptr_;
-    }
-};
-
 TEST_CASE("2---")
 {
     std::cout << "\n--------------------------\n\n";
@@ -95,31 +25,6 @@ void use(UniquePtr<Gadget> ptr_g)
         ptr_g->use();
 }
 
-// template <typename T>
-// UniquePtr<T> MakeUnique()
-// {
-//     return UniquePtr<T>{new T()};
-// }
-
-// template <typename T, typename TArg>
-// UniquePtr<T> MakeUnique(TArg&& arg)
-// {
-//     return UniquePtr<T>{new T(std::forward<TArg>(arg))};
-// }
-
-// template <typename T, typename TArg1, typename TArg2>
-// UniquePtr<T> MakeUnique(TArg1&& arg1, TArg2&& arg2)
-// {
-//     return UniquePtr<T>{new T(std::forward<TArg1>(arg1), std::forward<TArg2>(arg2))};
-// }
-
-
-template <typename T, typename... TArgs>
-UniquePtr<T> MakeUnique(TArgs&&... arg)
-{
-    return UniquePtr<T>{new T(std::forward<TArgs>(args)...)};
-}
-
 TEST_CASE("move semantics - UniquePtr")
 {
     UniquePtr<Gadget> pg1 = MakeUnique<Gadget>(1, "ipad");
@@ -0,0 +1,230 @@
+#ifndef RELOCATING_VECTOR_HPP
+#define RELOCATING_VECTOR_HPP
+
+#include "trivially_relocatable.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Vector of (move-only) objects that grows with realloc when IsTriviallyRelocatable<T> is set
+// - elements are relocated as bytes - no move constructor and destructor calls,
+//   and realloc can often extend the block in place without copying at all
+// - other types are moved one by one (as in std::vector)
+// - capacity grows 1, 2, 4, 8... (as std::vector in libstdc++) up to max_size() - beyond it std::length_error is thrown
+template <typename T>
+class RelocatingVector
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "storage is allocated with malloc");
+
+    T* items_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+
+    size_t next_capacity() const
+    {
+        if (capacity_ == max_size())
+            throw std::length_error("RelocatingVector: max_size() exceeded");
+
+        return capacity_ == 0 ? 1 : (capacity_ > max_size() / 2 ? max_size() : 2 * capacity_);
+    }
+
+    static void destroy(T* first, T* last) noexcept
+    {
+        for (; first != last; ++first)
+            first->~T();
+    }
+
+    void grow(size_t new_capacity)
+    {
+        grow(new_capacity, IsTriviallyRelocatable<T> {});
+    }
+
+    void grow(size_t new_capacity, std::true_type)
+    {
+        void* storage = std::realloc(static_cast<void*>(items_), new_capacity * sizeof(T)); // bytes are relocated by realloc
+        if (storage == nullptr)
+            throw std::bad_alloc {};
+
+        items_ = static_cast<T*>(storage);
+        capacity_ = new_capacity;
+    }
+
+    void grow(size_t new_capacity, std::false_type)
+    {
+        T* storage = static_cast<T*>(std::malloc(new_capacity * sizeof(T)));
+        if (storage == nullptr)
+            throw std::bad_alloc {};
+
+        size_t moved = 0;
+        try
+        {
+            for (; moved < size_; ++moved)
+                new (storage + moved) T(std::move_if_noexcept(items_[moved]));
+        }
+        catch (...)
+        {
+            destroy(storage, storage + moved);
+            std::free(storage);
+            throw;
+        }
+
+        destroy(items_, items_ + size_);
+        std::free(items_);
+
+        items_ = storage;
+        capacity_ = new_capacity;
+    }
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    RelocatingVector() = default;
+
+    RelocatingVector(const RelocatingVector&) = delete;
+    RelocatingVector& operator=(const RelocatingVector&) = delete;
+
+    RelocatingVector(RelocatingVector&& source) noexcept
+        : items_ {source.items_}
+        , size_ {source.size_}
+        , capacity_ {source.capacity_}
+    {
+        source.items_ = nullptr;
+        source.size_ = 0;
+        source.capacity_ = 0;
+    }
+
+    RelocatingVector& operator=(RelocatingVector&& source) noexcept
+    {
+        if (this != &source)
+        {
+            RelocatingVector temp = std::move(source);
+            swap(temp);
+        }
+
+        return *this;
+    }
+
+    ~RelocatingVector()
+    {
+        destroy(items_, items_ + size_);
+        std::free(items_);
+    }
+
+    void swap(RelocatingVector& other) noexcept
+    {
+        std::swap(items_, other.items_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // new_capacity * sizeof(T) bytes must not overflow
+    static constexpr size_t max_size() noexcept
+    {
+        return size_t(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+    }
+
+    void reserve(size_t new_capacity)
+    {
+        if (new_capacity > max_size())
+            throw std::length_error("RelocatingVector: reserve() exceeds max_size()");
+
+        if (new_capacity > capacity_)
+            grow(new_capacity);
+    }
+
+    T& operator[](size_t index) noexcept
+    {
+        return items_[index];
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        return items_[index];
+    }
+
+    T& back() noexcept
+    {
+        return items_[size_ - 1];
+    }
+
+    T* begin() noexcept
+    {
+        return items_;
+    }
+
+    T* end() noexcept
+    {
+        return items_ + size_;
+    }
+
+    const T* begin() const noexcept
+    {
+        return items_;
+    }
+
+    const T* end() const noexcept
+    {
+        return items_ + size_;
+    }
+
+    template <typename... TArgs>
+    T& emplace_back(TArgs&&... args)
+    {
+        if (size_ == capacity_)
+        {
+            T value(std::forward<TArgs>(args)...); // args may refer to elements that are about to be relocated
+            grow(next_capacity());
+            new (items_ + size_) T(std::move(value));
+        }
+        else
+        {
+            new (items_ + size_) T(std::forward<TArgs>(args)...);
+        }
+
+        return items_[size_++];
+    }
+
+    void push_back(const T& item)
+    {
+        emplace_back(item);
+    }
+
+    void push_back(T&& item)
+    {
+        emplace_back(std::move(item));
+    }
+
+    void pop_back() noexcept
+    {
+        items_[--size_].~T();
+    }
+
+    void clear() noexcept
+    {
+        destroy(items_, items_ + size_);
+        size_ = 0;
+    }
+};
+
+#endif
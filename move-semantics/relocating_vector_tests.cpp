@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "gadget.hpp"
+#include "relocating_vector.hpp"
+#include "unique_ptr.hpp"
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Tracked
+    {
+        static int move_count;
+
+        int value;
+
+        explicit Tracked(int v)
+            : value {v}
+        {
+        }
+
+        Tracked(Tracked&& source) noexcept
+            : value {source.value}
+        {
+            ++move_count;
+        }
+
+        ~Tracked()
+        {
+        }
+    };
+
+    int Tracked::move_count = 0;
+
+    struct RelocatableTracked : Tracked
+    {
+        using Tracked::Tracked;
+    };
+}
+
+template <>
+struct IsTriviallyRelocatable<RelocatableTracked> : std::true_type
+{
+};
+
+TEST_CASE("IsTriviallyRelocatable")
+{
+    static_assert(IsTriviallyRelocatable<int>::value, "trivially copyable");
+    static_assert(IsTriviallyRelocatable<Gadget*>::value, "trivially copyable");
+    static_assert(IsTriviallyRelocatable<UniquePtr<Gadget>>::value, "UniquePtr is relocatable");
+    static_assert(IsTriviallyRelocatable<UniquePtr<int[]>>::value, "UniquePtr is relocatable");
+    static_assert(IsTriviallyRelocatable<AllocatedUniquePtr<Gadget, std::allocator<Gadget>>>::value, "std::allocator is relocatable");
+    static_assert(IsTriviallyRelocatable<std::unique_ptr<Gadget>>::value, "std::unique_ptr is relocatable");
+    static_assert(!IsTriviallyRelocatable<std::string>::value, "std::string is not opted in");
+    static_assert(!IsTriviallyRelocatable<Tracked>::value, "classes are not relocatable by default");
+}
+
+TEST_CASE("RelocatingVector - relocatable elements")
+{
+    RelocatingVector<UniquePtr<Gadget>> gadgets;
+
+    gadgets.push_back(MakeUnique<Gadget>(1, "ipad"));
+    gadgets.emplace_back(MakeUnique<Gadget>(2, "smart-tv"));
+
+    UniquePtr<Gadget> g = MakeUnique<Gadget>(3, "smart-watch");
+    Gadget* raw = g.get();
+    gadgets.push_back(std::move(g));
+
+    REQUIRE(gadgets.size() == 3);
+    REQUIRE(gadgets.capacity() == 4);
+    REQUIRE(gadgets[2].get() == raw);
+
+    int id = 0;
+    for (const auto& g : gadgets)
+        REQUIRE(g->id == ++id);
+
+    SECTION("growth does not call move constructors")
+    {
+        RelocatingVector<RelocatableTracked> items;
+
+        Tracked::move_count = 0;
+        for (int i = 0; i < 1000; ++i)
+            items.emplace_back(i);
+
+        REQUIRE(Tracked::move_count == 11); // only the elements added while growing
+        REQUIRE(items[999].value == 999);
+    }
+
+    SECTION("move")
+    {
+        RelocatingVector<UniquePtr<Gadget>> target = std::move(gadgets);
+        REQUIRE(gadgets.empty());
+        REQUIRE(target.size() == 3);
+
+        target.pop_back();
+        REQUIRE(target.back()->id == 2);
+
+        target = RelocatingVector<UniquePtr<Gadget>> {};
+        REQUIRE(target.empty());
+    }
+
+    SECTION("capacities whose size in bytes overflows are rejected")
+    {
+        const size_t max_size = RelocatingVector<UniquePtr<Gadget>>::max_size();
+
+        REQUIRE_THROWS_AS(gadgets.reserve(max_size + 1), std::length_error);
+        REQUIRE_THROWS_AS(gadgets.reserve(std::numeric_limits<size_t>::max() / 2 + 1), std::length_error);
+        REQUIRE(gadgets.capacity() == 4);
+    }
+}
+
+TEST_CASE("RelocatingVector - other elements are moved")
+{
+    SECTION("move constructor is called while growing")
+    {
+        RelocatingVector<Tracked> items;
+
+        Tracked::move_count = 0;
+        for (int i = 0; i < 1000; ++i)
+            items.emplace_back(i);
+
+        REQUIRE(Tracked::move_count > 1000);
+        REQUIRE(items[999].value == 999);
+    }
+
+    SECTION("short strings point into themselves")
+    {
+        RelocatingVector<std::string> words;
+        std::vector<std::string> expected;
+
+        for (int i = 0; i < 128; ++i)
+        {
+            words.push_back(std::to_string(i));
+            expected.push_back(std::to_string(i));
+        }
+
+        words.emplace_back(words[0]); // argument refers to an element, vector grows
+
+        REQUIRE(std::equal(expected.begin(), expected.end(), words.begin()));
+        REQUIRE(words.back() == "0");
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef TRIVIALLY_RELOCATABLE_HPP
+#define TRIVIALLY_RELOCATABLE_HPP
+
+#include <memory>
+#include <type_traits>
+
+// Object can be moved to another address by copying its bytes and forgetting the source
+// - a move constructor followed by a destructor of the source does nothing more than that
+// - opt-in for classes: specialize for types that own their resources through pointers (UniquePtr, shared_ptr...)
+// - must not be set for types that point into themselves - e.g. std::string in libstdc++ (short string buffer)
+//   and classes that hold it as a member, like Data in move_semantics_3.cpp
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::allocator<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::default_delete<T>> : std::true_type
+{
+};
+
+template <typename T, typename TDeleter>
+struct IsTriviallyRelocatable<std::unique_ptr<T, TDeleter>> : IsTriviallyRelocatable<TDeleter>
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+#endif
@@ -0,0 +1,514 @@
+#ifndef UNIQUE_PTR_HPP
+#define UNIQUE_PTR_HPP
+
+#include "trivially_relocatable.hpp"
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+struct DefaultDelete;
+
+template <typename T, typename TDeleter = DefaultDelete<T>>
+class UniquePtr;
+
+template <typename T>
+struct DefaultDelete
+{
+    DefaultDelete() noexcept = default;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    DefaultDelete(const DefaultDelete<U>&) noexcept
+    {
+    }
+
+    void operator()(T* ptr) const noexcept
+    {
+        static_assert(sizeof(T) > 0, "cannot delete an incomplete type");
+        delete ptr;
+    }
+};
+
+template <typename T>
+struct DefaultDelete<T[]>
+{
+    DefaultDelete() noexcept = default;
+
+    void operator()(T* ptr) const noexcept
+    {
+        static_assert(sizeof(T) > 0, "cannot delete an incomplete type");
+        delete[] ptr;
+    }
+};
+
+namespace Detail
+{
+    // Holds a value that may be empty (deleter, allocator)
+    // - empty classes are stored as a base, so they take no space (empty base optimization)
+    template <typename TValue, bool = std::is_empty<TValue>::value && !std::is_final<TValue>::value>
+    class CompressedStorage : private TValue
+    {
+    public:
+        CompressedStorage() = default;
+
+        template <typename TArg>
+        explicit CompressedStorage(TArg&& value)
+            : TValue(std::forward<TArg>(value))
+        {
+        }
+
+        TValue& value() noexcept
+        {
+            return *this;
+        }
+
+        const TValue& value() const noexcept
+        {
+            return *this;
+        }
+    };
+
+    template <typename TValue>
+    class CompressedStorage<TValue, false>
+    {
+        TValue value_ {}; // value-initialized - a default-constructed function pointer deleter is nullptr
+
+    public:
+        CompressedStorage() = default;
+
+        template <typename TArg>
+        explicit CompressedStorage(TArg&& value)
+            : value_(std::forward<TArg>(value))
+        {
+        }
+
+        TValue& value() noexcept
+        {
+            return value_;
+        }
+
+        const TValue& value() const noexcept
+        {
+            return value_;
+        }
+    };
+
+    // selects the MakeUnique overload - single objects, arrays of unknown bound (T[]), arrays of known bound (T[N])
+    template <typename T>
+    struct UniqueIf
+    {
+        using SingleObject = UniquePtr<T>;
+    };
+
+    template <typename T>
+    struct UniqueIf<T[]>
+    {
+        using UnknownBound = UniquePtr<T[]>;
+    };
+
+    template <typename T, size_t N>
+    struct UniqueIf<T[N]>
+    {
+        using KnownBound = void;
+    };
+
+    // UniquePtr<T[]> owns U* only when U is T or less cv-qualified T -
+    // delete[] through a pointer to a base class is undefined behavior
+    template <typename U, typename T>
+    using EnableIfArrayPointer = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>;
+}
+
+// Stateless deleters (DefaultDelete, lambdas without captures) take no space - sizeof(UniquePtr<T>) == sizeof(T*)
+// Stateful deleters (returning objects to a pool or an arena) are stored next to the pointer
+template <typename T, typename TDeleter>
+class UniquePtr : private Detail::CompressedStorage<TDeleter>
+{
+    using DeleterStorage = Detail::CompressedStorage<TDeleter>;
+
+    T* ptr_;
+
+public:
+    using element_type = T;
+    using deleter_type = TDeleter;
+
+    UniquePtr(std::nullptr_t) noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    UniquePtr() noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    explicit UniquePtr(T* ptr) noexcept
+        : ptr_ {ptr}
+    {
+    }
+
+    UniquePtr(T* ptr, const TDeleter& deleter) noexcept
+        : DeleterStorage(deleter)
+        , ptr_ {ptr}
+    {
+    }
+
+    UniquePtr(T* ptr, TDeleter&& deleter) noexcept
+        : DeleterStorage(std::move(deleter))
+        , ptr_ {ptr}
+    {
+    }
+
+    UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
+
+    // move constructor
+    UniquePtr(UniquePtr&& source) noexcept
+        : DeleterStorage(std::move(source.get_deleter()))
+        , ptr_ {source.ptr_}
+    {
+        source.ptr_ = nullptr;
+    }
+
+    // converting move constructor - UniquePtr<Derived> -> UniquePtr<Base>
+    template <typename U, typename UDeleter,
+        typename = std::enable_if_t<std::is_convertible<U*, T*>::value && std::is_convertible<UDeleter, TDeleter>::value>>
+    UniquePtr(UniquePtr<U, UDeleter>&& source) noexcept
+        : DeleterStorage(std::forward<UDeleter>(source.get_deleter()))
+        , ptr_ {source.release()}
+    {
+    }
+
+    // move assignment operator
+    UniquePtr& operator=(UniquePtr&& source) noexcept
+    {
+        if (this != &source)
+        {
+            reset(source.release()); // deleting previous resource
+            get_deleter() = std::move(source.get_deleter());
+        }
+
+        return *this;
+    }
+
+    UniquePtr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~UniquePtr() noexcept
+    {
+        if (ptr_)
+            get_deleter()(ptr_);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *ptr_;
+    }
+
+    TDeleter& get_deleter() noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    const TDeleter& get_deleter() const noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    T* release() noexcept
+    {
+        T* ptr = ptr_;
+        ptr_ = nullptr;
+
+        return ptr;
+    }
+
+    void reset(T* ptr = nullptr) noexcept
+    {
+        T* old_ptr = ptr_;
+        ptr_ = ptr;
+
+        if (old_ptr)
+            get_deleter()(old_ptr);
+    }
+
+    void swap(UniquePtr& other) noexcept
+    {
+        using std::swap;
+        swap(ptr_, other.ptr_);
+        swap(get_deleter(), other.get_deleter());
+    }
+};
+
+// Array version - owns an array allocated with new[], released with delete[] by the default deleter
+template <typename T, typename TDeleter>
+class UniquePtr<T[], TDeleter> : private Detail::CompressedStorage<TDeleter>
+{
+    using DeleterStorage = Detail::CompressedStorage<TDeleter>;
+
+    T* ptr_;
+
+public:
+    using element_type = T;
+    using deleter_type = TDeleter;
+
+    UniquePtr(std::nullptr_t) noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    UniquePtr() noexcept
+        : ptr_ {nullptr}
+    {
+    }
+
+    template <typename U, typename = Detail::EnableIfArrayPointer<U, T>>
+    explicit UniquePtr(U* ptr) noexcept
+        : ptr_ {ptr}
+    {
+    }
+
+    template <typename U, typename = Detail::EnableIfArrayPointer<U, T>>
+    UniquePtr(U* ptr, const TDeleter& deleter) noexcept
+        : DeleterStorage(deleter)
+        , ptr_ {ptr}
+    {
+    }
+
+    template <typename U, typename = Detail::EnableIfArrayPointer<U, T>>
+    UniquePtr(U* ptr, TDeleter&& deleter) noexcept
+        : DeleterStorage(std::move(deleter))
+        , ptr_ {ptr}
+    {
+    }
+
+    UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
+
+    UniquePtr(UniquePtr&& source) noexcept
+        : DeleterStorage(std::move(source.get_deleter()))
+        , ptr_ {source.ptr_}
+    {
+        source.ptr_ = nullptr;
+    }
+
+    UniquePtr& operator=(UniquePtr&& source) noexcept
+    {
+        if (this != &source)
+        {
+            reset(source.release());
+            get_deleter() = std::move(source.get_deleter());
+        }
+
+        return *this;
+    }
+
+    UniquePtr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~UniquePtr() noexcept
+    {
+        if (ptr_)
+            get_deleter()(ptr_);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator[](size_t index) const noexcept
+    {
+        return ptr_[index];
+    }
+
+    TDeleter& get_deleter() noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    const TDeleter& get_deleter() const noexcept
+    {
+        return DeleterStorage::value();
+    }
+
+    T* release() noexcept
+    {
+        T* ptr = ptr_;
+        ptr_ = nullptr;
+
+        return ptr;
+    }
+
+    void reset(std::nullptr_t = nullptr) noexcept
+    {
+        reset(static_cast<T*>(nullptr));
+    }
+
+    template <typename U, typename = Detail::EnableIfArrayPointer<U, T>>
+    void reset(U* ptr) noexcept
+    {
+        T* old_ptr = ptr_;
+        ptr_ = ptr;
+
+        if (old_ptr)
+            get_deleter()(old_ptr);
+    }
+
+    void swap(UniquePtr& other) noexcept
+    {
+        using std::swap;
+        swap(ptr_, other.ptr_);
+        swap(get_deleter(), other.get_deleter());
+    }
+};
+
+template <typename T, typename TDeleter>
+void swap(UniquePtr<T, TDeleter>& a, UniquePtr<T, TDeleter>& b) noexcept
+{
+    a.swap(b);
+}
+
+// moving a UniquePtr copies the pointer (and the deleter) and nulls the source
+template <typename T, typename TDeleter>
+struct IsTriviallyRelocatable<UniquePtr<T, TDeleter>> : IsTriviallyRelocatable<TDeleter>
+{
+};
+
+// Destroys an object and gives its memory back to the allocator it came from
+// - stateless allocators (std::allocator) take no space, stateful ones (pools, arenas) are copied into the deleter
+template <typename TAllocator>
+class AllocatorDelete : private Detail::CompressedStorage<TAllocator>
+{
+    using AllocatorStorage = Detail::CompressedStorage<TAllocator>;
+    using Traits = std::allocator_traits<TAllocator>;
+
+public:
+    using value_type = typename Traits::value_type;
+
+    explicit AllocatorDelete(const TAllocator& allocator) noexcept
+        : AllocatorStorage(allocator)
+    {
+    }
+
+    void operator()(value_type* ptr) noexcept
+    {
+        Traits::destroy(AllocatorStorage::value(), ptr);
+        Traits::deallocate(AllocatorStorage::value(), ptr, 1);
+    }
+
+    const TAllocator& get_allocator() const noexcept
+    {
+        return AllocatorStorage::value();
+    }
+};
+
+template <typename TAllocator>
+struct IsTriviallyRelocatable<AllocatorDelete<TAllocator>> : IsTriviallyRelocatable<TAllocator>
+{
+};
+
+template <typename T, typename TAllocator>
+using AllocatedUniquePtr = UniquePtr<T, AllocatorDelete<typename std::allocator_traits<TAllocator>::template rebind_alloc<T>>>;
+
+// template <typename T>
+// UniquePtr<T> MakeUnique()
+// {
+//     return UniquePtr<T>{new T()};
+// }
+
+// template <typename T, typename TArg>
+// UniquePtr<T> MakeUnique(TArg&& arg)
+// {
+//     return UniquePtr<T>{new T(std::forward<TArg>(arg))};
+// }
+
+// template <typename T, typename TArg1, typename TArg2>
+// UniquePtr<T> MakeUnique(TArg1&& arg1, TArg2&& arg2)
+// {
+//     return UniquePtr<T>{new T(std::forward<TArg1>(arg1), std::forward<TArg2>(arg2))};
+// }
+
+template <typename T, typename... TArgs>
+typename Detail::UniqueIf<T>::SingleObject MakeUnique(TArgs&&... args)
+{
+    return UniquePtr<T>{new T(std::forward<TArgs>(args)...)};
+}
+
+// array of size elements - value-initialized (zeroed for int, double...)
+template <typename T>
+typename Detail::UniqueIf<T>::UnknownBound MakeUnique(size_t size)
+{
+    return UniquePtr<T>{new std::remove_extent_t<T>[size]()};
+}
+
+template <typename T, typename... TArgs>
+typename Detail::UniqueIf<T>::KnownBound MakeUnique(TArgs&&...) = delete;
+
+// default-initialized - trivial types are left uninitialized (no memset of buffers that are overwritten anyway)
+template <typename T>
+typename Detail::UniqueIf<T>::SingleObject MakeUniqueForOverwrite()
+{
+    return UniquePtr<T>{new T};
+}
+
+template <typename T>
+typename Detail::UniqueIf<T>::UnknownBound MakeUniqueForOverwrite(size_t size)
+{
+    return UniquePtr<T>{new std::remove_extent_t<T>[size]};
+}
+
+template <typename T, typename... TArgs>
+typename Detail::UniqueIf<T>::KnownBound MakeUniqueForOverwrite(TArgs&&...) = delete;
+
+// allocator-aware version - the object is created (and later released) by the allocator, never by the global heap
+// MakeUnique<Gadget>(std::allocator_arg, pool_allocator, 1, "ipad");
+template <typename T, typename TAllocator, typename... TArgs>
+AllocatedUniquePtr<T, std::decay_t<TAllocator>> MakeUnique(std::allocator_arg_t, TAllocator&& allocator, TArgs&&... args)
+{
+    using Allocator = typename std::allocator_traits<std::decay_t<TAllocator>>::template rebind_alloc<T>;
+    using Traits = std::allocator_traits<Allocator>;
+
+    Allocator alloc(std::forward<TAllocator>(allocator));
+    T* ptr = Traits::allocate(alloc, 1);
+
+    try
+    {
+        Traits::construct(alloc, ptr, std::forward<TArgs>(args)...);
+    }
+    catch (...)
+    {
+        Traits::deallocate(alloc, ptr, 1);
+        throw;
+    }
+
+    return AllocatedUniquePtr<T, std::decay_t<TAllocator>>{ptr, AllocatorDelete<Allocator>{alloc}};
+}
+
+#endif
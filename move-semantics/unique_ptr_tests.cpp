@@ -0,0 +1,327 @@
+#include "catch.hpp"
+#include "gadget.hpp"
+#include "unique_ptr.hpp"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    // fixed number of slots for objects of one type, free slots are kept on a list
+    template <typename T>
+    class ObjectPool
+    {
+        union Slot
+        {
+            Slot* next;
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+        };
+
+        std::vector<Slot> slots_;
+        Slot* free_ = nullptr;
+        size_t in_use_ = 0;
+
+    public:
+        explicit ObjectPool(size_t capacity)
+            : slots_(capacity)
+        {
+            for (auto& slot : slots_)
+            {
+                slot.next = free_;
+                free_ = &slot;
+            }
+        }
+
+        T* allocate()
+        {
+            if (free_ == nullptr)
+                throw std::bad_alloc {};
+
+            Slot* slot = free_;
+            free_ = slot->next;
+            ++in_use_;
+
+            return reinterpret_cast<T*>(&slot->storage);
+        }
+
+        void deallocate(T* ptr) noexcept
+        {
+            Slot* slot = reinterpret_cast<Slot*>(ptr);
+            slot->next = free_;
+            free_ = slot;
+            --in_use_;
+        }
+
+        bool owns(const T* ptr) const noexcept
+        {
+            const auto* slot = reinterpret_cast<const Slot*>(ptr);
+            return slot >= slots_.data() && slot < slots_.data() + slots_.size();
+        }
+
+        size_t in_use() const noexcept
+        {
+            return in_use_;
+        }
+    };
+
+    // stateful allocator - a pointer to the pool
+    template <typename T>
+    struct PoolAllocator
+    {
+        using value_type = T;
+
+        ObjectPool<T>* pool;
+
+        explicit PoolAllocator(ObjectPool<T>& p) noexcept
+            : pool {&p}
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            REQUIRE(n == 1);
+            return pool->allocate();
+        }
+
+        void deallocate(T* ptr, size_t) noexcept
+        {
+            pool->deallocate(ptr);
+        }
+    };
+
+    // stateful deleter returning objects straight to the pool
+    struct ReturnToPool
+    {
+        ObjectPool<Gadget>* pool;
+
+        void operator()(Gadget* g) const noexcept
+        {
+            g->~Gadget();
+            pool->deallocate(g);
+        }
+    };
+
+    int closed_count = 0;
+
+    struct CountingClose
+    {
+        void operator()(int* ptr) const noexcept
+        {
+            ++closed_count;
+            delete ptr;
+        }
+    };
+
+    struct Base
+    {
+        virtual ~Base() = default;
+    };
+
+    struct Derived : Base
+    {
+    };
+
+    template <typename TPointer, typename U, typename = void>
+    struct CanReset : std::false_type
+    {
+    };
+
+    template <typename TPointer, typename U>
+    struct CanReset<TPointer, U, decltype(std::declval<TPointer&>().reset(std::declval<U>()))> : std::true_type
+    {
+    };
+}
+
+TEST_CASE("UniquePtr - stateless deleters take no space")
+{
+    static_assert(sizeof(UniquePtr<Gadget>) == sizeof(Gadget*), "default deleter is stored with EBO");
+    static_assert(sizeof(UniquePtr<int, CountingClose>) == sizeof(int*), "empty deleter is stored with EBO");
+    static_assert(sizeof(AllocatedUniquePtr<Gadget, std::allocator<Gadget>>) == sizeof(Gadget*), "std::allocator is stored with EBO");
+
+    auto lambda_deleter = [](int* ptr) { delete ptr; };
+    static_assert(sizeof(UniquePtr<int, decltype(lambda_deleter)>) == sizeof(int*), "lambda without captures is stored with EBO");
+
+    closed_count = 0;
+    {
+        UniquePtr<int, CountingClose> ptr {new int(42)};
+        REQUIRE(*ptr == 42);
+
+        UniquePtr<int, CountingClose> target = std::move(ptr);
+        REQUIRE(ptr.get() == nullptr);
+        REQUIRE(closed_count == 0);
+
+        target.reset(new int(665));
+        REQUIRE(closed_count == 1);
+    }
+    REQUIRE(closed_count == 2);
+}
+
+TEST_CASE("UniquePtr - stateful deleter returns objects to a pool")
+{
+    ObjectPool<Gadget> pool {4};
+
+    {
+        UniquePtr<Gadget, ReturnToPool> g1 {new (pool.allocate()) Gadget {1, "ipad"}, ReturnToPool {&pool}};
+        REQUIRE(g1.get_deleter().pool == &pool);
+        REQUIRE(pool.in_use() == 1);
+
+        UniquePtr<Gadget, ReturnToPool> g2 {new (pool.allocate()) Gadget {2, "smart-tv"}, ReturnToPool {&pool}};
+        g2 = std::move(g1);
+        REQUIRE(pool.in_use() == 1);
+        REQUIRE(g2->id == 1);
+
+        g2.swap(g1);
+        REQUIRE(g1->id == 1);
+        REQUIRE(g2.get() == nullptr);
+    }
+
+    REQUIRE(pool.in_use() == 0);
+}
+
+TEST_CASE("UniquePtr - default-constructed function pointer deleter is null")
+{
+    using FunctionDeleted = UniquePtr<int, void (*)(int*)>;
+
+    FunctionDeleted empty;
+    REQUIRE(empty.get() == nullptr);
+    REQUIRE(empty.get_deleter() == nullptr);
+
+    FunctionDeleted moved = std::move(empty);
+    REQUIRE(moved.get_deleter() == nullptr);
+
+    FunctionDeleted owner {new int(42), [](int* ptr) { delete ptr; }};
+    owner.swap(moved);
+    REQUIRE(owner.get_deleter() == nullptr);
+    REQUIRE(*moved == 42);
+    REQUIRE(moved.get_deleter() != nullptr);
+}
+
+TEST_CASE("MakeUnique with allocator")
+{
+    SECTION("pooled gadgets never reach the global heap")
+    {
+        ObjectPool<Gadget> pool {2};
+        PoolAllocator<Gadget> allocator {pool};
+
+        {
+            auto g1 = MakeUnique<Gadget>(std::allocator_arg, allocator, 1, "ipad");
+            auto g2 = MakeUnique<Gadget>(std::allocator_arg, allocator, 2, "smart-watch");
+
+            static_assert(sizeof(g1) == sizeof(Gadget*) + sizeof(PoolAllocator<Gadget>), "stateful allocator is stored");
+
+            REQUIRE(pool.owns(g1.get()));
+            REQUIRE(pool.owns(g2.get()));
+            REQUIRE(pool.in_use() == 2);
+            REQUIRE(g2->name == "smart-watch");
+
+            REQUIRE_THROWS_AS(MakeUnique<Gadget>(std::allocator_arg, allocator, 3, "roomba"), std::bad_alloc);
+
+            g1.reset();
+            REQUIRE(pool.in_use() == 1);
+
+            auto g3 = MakeUnique<Gadget>(std::allocator_arg, allocator, 3, "roomba");
+            REQUIRE(pool.owns(g3.get()));
+        }
+
+        REQUIRE(pool.in_use() == 0);
+    }
+
+    SECTION("std::allocator")
+    {
+        auto g = MakeUnique<Gadget>(std::allocator_arg, std::allocator<int> {}, 4, "smart-tv");
+        REQUIRE(g->id == 4);
+    }
+}
+
+TEST_CASE("UniquePtr - conversions")
+{
+    UniquePtr<Derived> derived = MakeUnique<Derived>();
+    Derived* raw = derived.get();
+
+    UniquePtr<Base> base = std::move(derived);
+    REQUIRE(base.get() == raw);
+    REQUIRE(derived.get() == nullptr);
+
+    base = nullptr;
+    REQUIRE(!base);
+}
+
+namespace
+{
+    struct Counted
+    {
+        static int alive;
+
+        int value = 7;
+
+        Counted()
+        {
+            ++alive;
+        }
+
+        ~Counted()
+        {
+            --alive;
+        }
+    };
+
+    int Counted::alive = 0;
+}
+
+TEST_CASE("UniquePtr<T[]>")
+{
+    static_assert(sizeof(UniquePtr<int[]>) == sizeof(int*), "default deleter is stored with EBO");
+    static_assert(!std::is_constructible<UniquePtr<Base[]>, Derived*>::value, "delete[] through Base* is undefined");
+    static_assert(!CanReset<UniquePtr<Base[]>, Derived*>::value, "delete[] through Base* is undefined");
+    static_assert(std::is_constructible<UniquePtr<const int[]>, int*>::value, "adding const is safe");
+    static_assert(CanReset<UniquePtr<const int[]>, int*>::value, "adding const is safe");
+    static_assert(CanReset<UniquePtr<int[]>, std::nullptr_t>::value, "reset to nullptr");
+
+    SECTION("delete[] releases all elements")
+    {
+        {
+            UniquePtr<Counted[]> tab {new Counted[16]};
+            REQUIRE(Counted::alive == 16);
+            REQUIRE(tab[15].value == 7);
+
+            UniquePtr<Counted[]> other = std::move(tab);
+            REQUIRE(tab.get() == nullptr);
+
+            other.reset(new Counted[4]);
+            REQUIRE(Counted::alive == 4);
+        }
+
+        REQUIRE(Counted::alive == 0);
+    }
+
+    SECTION("MakeUnique value-initializes")
+    {
+        UniquePtr<int[]> tab = MakeUnique<int[]>(1024);
+
+        tab[100] = 562;
+        tab[101] = 42;
+
+        REQUIRE(tab[0] == 0);
+        REQUIRE(tab[100] == 562);
+        REQUIRE(tab[1023] == 0);
+    }
+
+    SECTION("MakeUniqueForOverwrite default-initializes")
+    {
+        UniquePtr<int[]> buffer = MakeUniqueForOverwrite<int[]>(1 << 20);
+        for (int i = 0; i < (1 << 20); ++i)
+            buffer[i] = i;
+
+        REQUIRE(buffer[(1 << 20) - 1] == (1 << 20) - 1);
+
+        // class types are still constructed
+        UniquePtr<Counted[]> items = MakeUniqueForOverwrite<Counted[]>(8);
+        REQUIRE(Counted::alive == 8);
+        REQUIRE(items[7].value == 7);
+
+        UniquePtr<Counted> item = MakeUniqueForOverwrite<Counted>();
+        REQUIRE(item->value == 7);
+    }
+}
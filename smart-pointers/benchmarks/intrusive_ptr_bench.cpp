@@ -0,0 +1,105 @@
+#include "../intrusive_ptr.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// copy and destroy costs: IntrusivePtr (atomic and non-atomic count) vs std::shared_ptr
+
+namespace
+{
+    constexpr size_t count = 1 << 20;
+
+    struct Payload
+    {
+        int value = 1;
+    };
+
+    struct AtomicPayload : RefCounted<AtomicPayload, AtomicCount>
+    {
+        int value = 1;
+    };
+
+    struct LocalPayload : RefCounted<LocalPayload, NonAtomicCount>
+    {
+        int value = 1;
+    };
+
+    struct Timings
+    {
+        double copy_ns = 0.0;
+        double destroy_ns = 0.0;
+    };
+
+    // copies every pointer of originals into a reserved vector (timed), then destroys the copies (timed)
+    template <typename TPointer>
+    Timings measure_copy_destroy(const std::vector<TPointer>& originals, int repetitions = 5)
+    {
+        Timings best;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            std::vector<TPointer> copies;
+            copies.reserve(originals.size());
+
+            const auto start = Bench::Clock::now();
+            for (const auto& ptr : originals)
+                copies.push_back(ptr);
+            const auto copied = Bench::Clock::now();
+            Bench::do_not_optimize(copies);
+            copies.clear();
+            const auto stop = Bench::Clock::now();
+            Bench::do_not_optimize(copies);
+
+            const double copy_ns = std::chrono::duration<double, std::nano>(copied - start).count();
+            const double destroy_ns = std::chrono::duration<double, std::nano>(stop - copied).count();
+
+            best.copy_ns = (i == 0) ? copy_ns : std::min(best.copy_ns, copy_ns);
+            best.destroy_ns = (i == 0) ? destroy_ns : std::min(best.destroy_ns, destroy_ns);
+        }
+
+        return best;
+    }
+
+    template <typename TPointer, typename TFactory>
+    void run(const std::string& kind, TFactory make)
+    {
+        const std::string name = kind + " " + std::to_string(sizeof(TPointer)) + "B";
+
+        // one object referenced count times
+        const std::vector<TPointer> same(count, make());
+        const Timings same_timings = measure_copy_destroy(same);
+        Bench::report("copy same - " + name, same_timings.copy_ns, count);
+        Bench::report("destroy same - " + name, same_timings.destroy_ns, count);
+
+        // count distinct objects
+        std::vector<TPointer> distinct;
+        distinct.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            distinct.push_back(make());
+
+        const Timings distinct_timings = measure_copy_destroy(distinct);
+        Bench::report("copy distinct - " + name, distinct_timings.copy_ns, count);
+        Bench::report("destroy distinct - " + name, distinct_timings.destroy_ns, count);
+    }
+}
+
+int main()
+{
+    std::cout << count << " pointers per run\n";
+
+    // libstdc++ updates shared_ptr counts without atomics until the process starts its first thread
+    std::cout << "\nsingle-threaded process\n";
+    run<std::shared_ptr<Payload>>("shared_ptr", [] { return std::make_shared<Payload>(); });
+
+    std::thread([] {}).join();
+
+    std::cout << "\nafter a thread was started\n";
+    run<std::shared_ptr<Payload>>("shared_ptr", [] { return std::make_shared<Payload>(); });
+    run<IntrusivePtr<AtomicPayload>>("IntrusivePtr<Atomic>", [] { return make_intrusive<AtomicPayload>(); });
+    run<IntrusivePtr<LocalPayload>>("IntrusivePtr<NonAtomic>", [] { return make_intrusive<LocalPayload>(); });
+}
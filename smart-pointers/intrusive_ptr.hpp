@@ -0,0 +1,264 @@
+#ifndef INTRUSIVE_PTR_HPP
+#define INTRUSIVE_PTR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// keeps the deleting path out of line - GCC cannot see that the count of an object
+// released twice in one function was above 1 and reports a use-after-free
+#if defined(__GNUC__) || defined(__clang__)
+#define INTRUSIVE_PTR_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define INTRUSIVE_PTR_NOINLINE __declspec(noinline)
+#else
+#define INTRUSIVE_PTR_NOINLINE
+#endif
+
+// Counter policies for RefCounted
+
+// objects may be shared between threads
+struct AtomicCount
+{
+    using Type = std::atomic<long>;
+
+    static void increment(Type& count) noexcept
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // returns the new value - acq_rel: the thread that destroys the object sees all writes made through other pointers
+    static long decrement(Type& count) noexcept
+    {
+        return count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    }
+
+    static long load(const Type& count) noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+};
+
+// objects used by a single thread - no locked instructions
+struct NonAtomicCount
+{
+    using Type = long;
+
+    static void increment(Type& count) noexcept
+    {
+        ++count;
+    }
+
+    static long decrement(Type& count) noexcept
+    {
+        return --count;
+    }
+
+    static long load(const Type& count) noexcept
+    {
+        return count;
+    }
+};
+
+// Base class keeping the reference count inside the object (no separate control block)
+// - objects are deleted as TDerived (through a static_cast) - IntrusivePtr lets a pointer to a base class
+//   own objects of derived classes only when the base class has a virtual destructor
+// - copies of an object start with their own count of zero
+template <typename TDerived, typename TCountPolicy = AtomicCount>
+class RefCounted
+{
+    mutable typename TCountPolicy::Type ref_count_ {0};
+
+    friend void intrusive_add_ref(const RefCounted* ptr) noexcept
+    {
+        TCountPolicy::increment(ptr->ref_count_);
+    }
+
+    friend void intrusive_release(const RefCounted* ptr) noexcept
+    {
+        if (TCountPolicy::decrement(ptr->ref_count_) == 0)
+            destroy(ptr);
+    }
+
+    INTRUSIVE_PTR_NOINLINE static void destroy(const RefCounted* ptr) noexcept
+    {
+        delete static_cast<const TDerived*>(ptr);
+    }
+
+protected:
+    RefCounted() noexcept = default;
+
+    RefCounted(const RefCounted&) noexcept
+    {
+    }
+
+    RefCounted& operator=(const RefCounted&) noexcept
+    {
+        return *this;
+    }
+
+    ~RefCounted() = default;
+
+public:
+    using count_policy = TCountPolicy;
+
+    long use_count() const noexcept
+    {
+        return TCountPolicy::load(ref_count_);
+    }
+};
+
+// Shared ownership of an object that counts its references itself (RefCounted)
+// - one word wide - sizeof(IntrusivePtr<T>) == sizeof(T*)
+// - no weak references
+template <typename T>
+class IntrusivePtr
+{
+    T* ptr_ = nullptr;
+
+    // U is deleted as T - objects of derived classes need a virtual destructor in T
+    template <typename U>
+    using EnableIfOwnable = std::enable_if_t<std::is_convertible_v<U*, T*> &&
+        (std::is_same_v<std::remove_cv_t<U>, std::remove_cv_t<T>> || std::has_virtual_destructor_v<T>)>;
+
+public:
+    using element_type = T;
+
+    IntrusivePtr() noexcept = default;
+
+    IntrusivePtr(std::nullptr_t) noexcept
+    {
+    }
+
+    // add_ref == false adopts a reference that was already counted (see detach())
+    template <typename U, typename = EnableIfOwnable<U>>
+    explicit IntrusivePtr(U* ptr, bool add_ref = true) noexcept
+        : ptr_ {ptr}
+    {
+        if (ptr_ && add_ref)
+            intrusive_add_ref(ptr_);
+    }
+
+    // adopts an object owned by unique_ptr
+    template <typename U, typename = EnableIfOwnable<U>>
+    IntrusivePtr(std::unique_ptr<U>&& source) noexcept
+        : IntrusivePtr(source.release())
+    {
+    }
+
+    IntrusivePtr(const IntrusivePtr& source) noexcept
+        : IntrusivePtr(source.ptr_)
+    {
+    }
+
+    template <typename U, typename = EnableIfOwnable<U>>
+    IntrusivePtr(const IntrusivePtr<U>& source) noexcept
+        : IntrusivePtr(source.get())
+    {
+    }
+
+    IntrusivePtr(IntrusivePtr&& source) noexcept
+        : ptr_ {std::exchange(source.ptr_, nullptr)}
+    {
+    }
+
+    template <typename U, typename = EnableIfOwnable<U>>
+    IntrusivePtr(IntrusivePtr<U>&& source) noexcept
+        : ptr_ {source.detach()}
+    {
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& source) noexcept
+    {
+        IntrusivePtr(source).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& source) noexcept
+    {
+        IntrusivePtr(std::move(source)).swap(*this);
+        return *this;
+    }
+
+    ~IntrusivePtr()
+    {
+        if (ptr_)
+            intrusive_release(ptr_);
+    }
+
+    void reset() noexcept
+    {
+        IntrusivePtr().swap(*this);
+    }
+
+    template <typename U, typename = EnableIfOwnable<U>>
+    void reset(U* ptr) noexcept
+    {
+        IntrusivePtr(ptr).swap(*this);
+    }
+
+    // gives up ownership without decrementing the count
+    T* detach() noexcept
+    {
+        return std::exchange(ptr_, nullptr);
+    }
+
+    void swap(IntrusivePtr& other) noexcept
+    {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    T* get() const noexcept
+    {
+        return ptr_;
+    }
+
+    T& operator*() const noexcept
+    {
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept
+    {
+        return ptr_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept
+{
+    return a.get() == b.get();
+}
+
+template <typename T, typename U>
+bool operator!=(const IntrusivePtr<T>& a, const IntrusivePtr<U>& b) noexcept
+{
+    return a.get() != b.get();
+}
+
+template <typename T>
+bool operator==(const IntrusivePtr<T>& a, std::nullptr_t) noexcept
+{
+    return a.get() == nullptr;
+}
+
+template <typename T>
+bool operator!=(const IntrusivePtr<T>& a, std::nullptr_t) noexcept
+{
+    return a.get() != nullptr;
+}
+
+template <typename T, typename... TArgs>
+IntrusivePtr<T> make_intrusive(TArgs&&... args)
+{
+    return IntrusivePtr<T>(new T(std::forward<TArgs>(args)...));
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "intrusive_ptr.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+using namespace Utils;
+
+namespace
+{
+    int destroyed_count = 0;
+
+    template <typename TCountPolicy>
+    class CountedGadget : public Gadget, public RefCounted<CountedGadget<TCountPolicy>, TCountPolicy>
+    {
+    public:
+        using Gadget::Gadget;
+
+        ~CountedGadget()
+        {
+            ++destroyed_count;
+        }
+    };
+
+    using SharedGadget = CountedGadget<AtomicCount>;
+    using LocalGadget = CountedGadget<NonAtomicCount>;
+
+    struct Node : RefCounted<Node, NonAtomicCount>
+    {
+        int value = 0;
+
+        virtual ~Node() = default; // DerivedNodes are owned through IntrusivePtr<Node>
+    };
+
+    struct DerivedNode : Node
+    {
+        DerivedNode()
+        {
+            value = 42;
+        }
+    };
+
+    struct PlainNode : RefCounted<PlainNode, NonAtomicCount>
+    {
+    };
+
+    struct DerivedPlainNode : PlainNode
+    {
+        std::string name;
+    };
+}
+
+TEST_CASE("IntrusivePtr is one word")
+{
+    static_assert(sizeof(IntrusivePtr<SharedGadget>) == sizeof(SharedGadget*));
+    static_assert(sizeof(IntrusivePtr<LocalGadget>) == sizeof(LocalGadget*));
+    static_assert(sizeof(std::shared_ptr<Gadget>) == 2 * sizeof(Gadget*));
+}
+
+TEST_CASE("IntrusivePtr - derived objects need a virtual destructor in the base")
+{
+    static_assert(std::is_constructible_v<IntrusivePtr<Node>, IntrusivePtr<DerivedNode>>);
+    static_assert(std::is_constructible_v<IntrusivePtr<Node>, DerivedNode*>);
+
+    // DerivedPlainNode would be deleted as PlainNode
+    static_assert(!std::is_constructible_v<IntrusivePtr<PlainNode>, IntrusivePtr<DerivedPlainNode>>);
+    static_assert(!std::is_constructible_v<IntrusivePtr<PlainNode>, std::unique_ptr<DerivedPlainNode>>);
+    static_assert(!std::is_constructible_v<IntrusivePtr<PlainNode>, DerivedPlainNode*>);
+    static_assert(std::is_constructible_v<IntrusivePtr<const PlainNode>, PlainNode*>);
+}
+
+TEST_CASE("IntrusivePtr - shared ownership")
+{
+    destroyed_count = 0;
+
+    auto sp1 = make_intrusive<SharedGadget>(1, "ipad1");
+    REQUIRE(sp1->use_count() == 1);
+
+    {
+        auto sp2 = sp1;
+        REQUIRE(sp1->use_count() == 2);
+        REQUIRE(sp2 == sp1);
+
+        IntrusivePtr<SharedGadget> sp3 = std::move(sp2);
+        REQUIRE(sp2 == nullptr);
+        REQUIRE(sp1->use_count() == 2);
+
+        sp3 = sp1;
+        REQUIRE(sp1->use_count() == 2);
+    }
+
+    REQUIRE(sp1->use_count() == 1);
+    REQUIRE(destroyed_count == 0);
+
+    SECTION("raw pointer gets a counted reference back")
+    {
+        SharedGadget* raw = sp1.get();
+        IntrusivePtr<SharedGadget> sp4 {raw}; // count is in the object - no double delete
+        REQUIRE(raw->use_count() == 2);
+    }
+
+    SECTION("detach and adopt")
+    {
+        SharedGadget* raw = sp1.detach();
+        REQUIRE(raw->use_count() == 1);
+
+        IntrusivePtr<SharedGadget> adopted {raw, false};
+        REQUIRE(adopted->use_count() == 1);
+    }
+
+    sp1.reset();
+    REQUIRE(destroyed_count == 1);
+}
+
+TEST_CASE("IntrusivePtr - copies of objects have their own count")
+{
+    auto g1 = make_intrusive<LocalGadget>(1, "smart-tv");
+    auto g2 = make_intrusive<LocalGadget>(*g1);
+    auto g3 = g2;
+
+    *g3 = *g1;
+
+    REQUIRE(g1->use_count() == 1);
+    REQUIRE(g2->use_count() == 2);
+    REQUIRE(g2->name() == "smart-tv");
+}
+
+TEST_CASE("IntrusivePtr - adopting unique_ptr")
+{
+    destroyed_count = 0;
+
+    std::unique_ptr<LocalGadget> up = std::make_unique<LocalGadget>(2, "smart-watch");
+    LocalGadget* raw = up.get();
+
+    IntrusivePtr<LocalGadget> ip = std::move(up);
+    REQUIRE(up == nullptr);
+    REQUIRE(ip.get() == raw);
+    REQUIRE(ip->use_count() == 1);
+
+    ip = nullptr;
+    REQUIRE(destroyed_count == 1);
+
+    IntrusivePtr<Node> node = std::make_unique<DerivedNode>();
+    REQUIRE(node->value == 42);
+
+    IntrusivePtr<Node> other = IntrusivePtr<DerivedNode> {new DerivedNode};
+    REQUIRE(other->use_count() == 1);
+}
+
+TEST_CASE("IntrusivePtr - atomic count is shared between threads")
+{
+    destroyed_count = 0;
+
+    auto shared = make_intrusive<SharedGadget>(3, "roomba");
+    std::atomic<bool> count_dropped {false};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([shared, &count_dropped] {
+            for (int i = 0; i < 100'000; ++i)
+            {
+                IntrusivePtr<SharedGadget> copy = shared;
+                if (!copy || copy->use_count() < 2)
+                    count_dropped = true;
+            }
+        });
+    }
+
+    for (auto& thd : threads)
+        thd.join();
+
+    REQUIRE_FALSE(count_dropped);
+    REQUIRE(shared->use_count() == 1);
+    REQUIRE(destroyed_count == 0);
+}